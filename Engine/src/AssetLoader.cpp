@@ -0,0 +1,44 @@
+#include "AssetLoader.h"
+#include "ResourceManager.h"
+#include "ThreadPool.h"
+#include <SDL_image.h>
+#include <SDL_mixer.h>
+
+AssetLoader::AssetLoader(ThreadPool *pool) :
+_pool(pool)
+{
+}
+
+std::future<AssetResult<Mix_Chunk> > AssetLoader::LoadWav(const char *path)
+{
+  std::string file(path);
+  return _pool->Submit([file]()
+  {
+    AssetResult<Mix_Chunk> result;
+    result.asset = ResourceTraits<Mix_Chunk>::Load(file.c_str());
+
+    // SDL keeps its error message per thread, so read it here rather than on the game thread.
+    if (result.asset == nullptr)
+    {
+      result.error = Mix_GetError();
+    }
+
+    return result;
+  });
+}
+
+std::future<AssetResult<SDL_Surface> > AssetLoader::LoadImage(const char *path)
+{
+  std::string file(path);
+  return _pool->Submit([file]()
+  {
+    AssetResult<SDL_Surface> result;
+    result.asset = ResourceTraits<SDL_Surface>::Load(file.c_str());
+    if (result.asset == nullptr)
+    {
+      result.error = IMG_GetError();
+    }
+
+    return result;
+  });
+}
\ No newline at end of file
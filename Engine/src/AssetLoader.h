@@ -0,0 +1,51 @@
+/**
+ * \class AssetLoader
+ * \brief Loads and decodes assets on a ThreadPool, so startup waits for the slowest asset rather than for all of them in turn.
+ *
+ * Every load returns a future right away. Callers keep using a placeholder (a silent sound, say) and poll the
+ * future from the game loop until the asset arrives.
+ */
+
+#pragma once
+#include <future>
+#include <string>
+
+class ThreadPool;
+struct Mix_Chunk;
+struct SDL_Surface;
+
+// What a load produces: the asset, or NULL and the reason it couldn't be loaded.
+template <typename T>
+struct AssetResult
+{
+  T *asset;
+  std::string error;
+};
+
+class AssetLoader
+{
+public:
+  /**
+  * \fn AssetLoader::AssetLoader(ThreadPool *pool)
+  * \brief Creates a loader that decodes on the given pool.
+  * \param pool The pool the loads run on. It must outlive every load.
+  */
+  AssetLoader(ThreadPool *pool);
+
+  /**
+  * \fn std::future<AssetResult<Mix_Chunk> > AssetLoader::LoadWav(const char *path)
+  * \brief Loads a WAV file and converts it to the format the mixer was opened with. The audio device must be open.
+  * \param path The file to load.
+  */
+  std::future<AssetResult<Mix_Chunk> > LoadWav(const char *path);
+
+  /**
+  * \fn std::future<AssetResult<SDL_Surface> > AssetLoader::LoadImage(const char *path)
+  * \brief Loads an image with SDL_image. Turning it into a texture is left to the thread owning the renderer.
+  * \param path The file to load.
+  */
+  std::future<AssetResult<SDL_Surface> > LoadImage(const char *path);
+
+protected:
+  ThreadPool *_pool;
+};
\ No newline at end of file
@@ -0,0 +1,339 @@
+#include "AudioManager.h"
+#include <SDL_mixer.h>
+#include <algorithm>
+#include <stdio.h>
+
+AudioManager* AudioManager::_instance = NULL;
+
+AudioManager* AudioManager::GetInstance()
+{
+  if (_instance == NULL)
+  {
+    _instance = new AudioManager();
+  }
+
+  return _instance;
+}
+
+void AudioManager::DestroyInstance()
+{
+  if (_instance != NULL)
+  {
+    delete _instance;
+    _instance = NULL;
+  }
+}
+
+AudioManager::AudioManager() :
+_isOpen(false),
+_startCounter(0)
+{
+}
+
+AudioManager::~AudioManager()
+{
+  Close();
+}
+
+bool AudioManager::Open(int frequency, Uint16 format, int channels, int chunkSize, int voices)
+{
+  if (_isOpen)
+  {
+    return true;
+  }
+
+  if (Mix_OpenAudio(frequency, format, channels, chunkSize) != 0)
+  {
+    return false;
+  }
+
+  Mix_AllocateChannels(voices);
+
+  Voice idle = { kInvalidSound, 0 };
+  _voices.assign(voices, idle);
+  _isOpen = true;
+  return true;
+}
+
+void AudioManager::Close()
+{
+  if (_isOpen == false)
+  {
+    return;
+  }
+
+  // Sounds still decoding hold chunks too, wait for them so they can be freed.
+  CollectLoadedSounds(true);
+
+  Mix_HaltChannel(-1);
+  SoundCache &cache = ResourceManager::GetInstance()->GetSounds();
+  for (auto itr = _sounds.begin(); itr != _sounds.end(); itr++)
+  {
+    cache.Release(itr->handle);
+  }
+
+  // Cached chunks were converted for the device being closed, they are no use to the next one.
+  cache.EvictUnreferenced();
+
+  _sounds.clear();
+  _voices.clear();
+  _triggered.clear();
+
+  Mix_CloseAudio();
+  Mix_Quit();
+  _isOpen = false;
+}
+
+SoundId AudioManager::LoadSound(const char *path, int priority, int maxInstances)
+{
+  if (_isOpen == false)
+  {
+    return kInvalidSound;
+  }
+
+  SoundCache::Handle handle = ResourceManager::GetInstance()->GetSounds().Acquire(path);
+  if (handle.IsValid() == false)
+  {
+    return kInvalidSound;
+  }
+
+  return AddSound(handle, priority, maxInstances);
+}
+
+SoundId AudioManager::LoadSoundAsync(const char *path, int priority, int maxInstances, AssetLoader *loader)
+{
+  if (_isOpen == false)
+  {
+    return kInvalidSound;
+  }
+
+  // Already loaded for another sound, nothing to decode.
+  SoundCache::Handle handle = ResourceManager::GetInstance()->GetSounds().Find(path);
+  if (handle.IsValid())
+  {
+    return AddSound(handle, priority, maxInstances);
+  }
+
+  PendingSound pending;
+  pending.sound = AddSound(SoundCache::Handle(), priority, maxInstances);
+  pending.path = path;
+  pending.result = loader->LoadWav(path).share();
+  _pending.push_back(pending);
+
+  return pending.sound;
+}
+
+bool AudioManager::IsLoading() const
+{
+  return _pending.empty() == false;
+}
+
+void AudioManager::CollectLoadedSounds(bool wait)
+{
+  for (auto itr = _pending.begin(); itr != _pending.end();)
+  {
+    if (wait == false && itr->result.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+      itr++;
+      continue;
+    }
+
+    const AssetResult<Mix_Chunk> &result = itr->result.get();
+    if (result.asset == nullptr)
+    {
+      printf("AudioManager: could not load %s: %s\n", itr->path.c_str(), result.error.c_str());
+    }
+    else
+    {
+      SoundCache &cache = ResourceManager::GetInstance()->GetSounds();
+      Sound &sound = _sounds[itr->sound];
+      sound.handle = cache.Insert(itr->path.c_str(), result.asset);
+      sound.chunk = cache.Get(sound.handle);
+    }
+    itr = _pending.erase(itr);
+  }
+}
+
+SoundId AudioManager::AddSound(SoundCache::Handle handle, int priority, int maxInstances)
+{
+  Sound sound;
+  sound.handle = handle;
+  sound.chunk = ResourceManager::GetInstance()->GetSounds().Get(handle);
+  sound.priority = priority;
+  sound.maxInstances = (maxInstances > 0) ? maxInstances : 1;
+  sound.instances = 0;
+  sound.isTriggered = false;
+  _sounds.push_back(sound);
+
+  return (SoundId)_sounds.size() - 1;
+}
+
+void AudioManager::Play(SoundId sound)
+{
+  // A sound still loading (or that failed to) has no data yet and plays as silence.
+  if (sound < 0 || sound >= (SoundId)_sounds.size() || _sounds[sound].isTriggered || _sounds[sound].chunk == nullptr)
+  {
+    return;
+  }
+
+  _sounds[sound].isTriggered = true;
+  _triggered.push_back(sound);
+}
+
+void AudioManager::Update()
+{
+  if (_isOpen == false)
+  {
+    return;
+  }
+
+  if (_pending.empty() == false)
+  {
+    CollectLoadedSounds(false);
+  }
+
+  // Give back the voices of sounds that finished on their own.
+  for (int channel = 0; channel < (int)_voices.size(); channel++)
+  {
+    if (_voices[channel].sound != kInvalidSound && Mix_Playing(channel) == 0)
+    {
+      ReleaseVoice(channel);
+    }
+  }
+
+  if (_triggered.empty())
+  {
+    return;
+  }
+
+  // Most important first, so they get the free voices.
+  std::stable_sort(_triggered.begin(), _triggered.end(), [this](SoundId first, SoundId second)
+  {
+    return _sounds[first].priority > _sounds[second].priority;
+  });
+
+  for (auto itr = _triggered.begin(); itr != _triggered.end(); itr++)
+  {
+    SoundId id = *itr;
+    Sound &sound = _sounds[id];
+    sound.isTriggered = false;
+
+    int channel;
+    if (sound.instances >= sound.maxInstances)
+    {
+      // At its cap: restart its own oldest instance rather than taking another voice.
+      channel = FindVoice(id);
+    }
+    else
+    {
+      channel = FindVoice(kInvalidSound);
+      if (channel < 0)
+      {
+        channel = FindVoiceToSteal(sound.priority);
+      }
+    }
+
+    if (channel >= 0)
+    {
+      StartVoice(channel, id);
+    }
+  }
+
+  _triggered.clear();
+}
+
+int AudioManager::GetActiveVoiceCount() const
+{
+  int count = 0;
+  for (auto itr = _voices.begin(); itr != _voices.end(); itr++)
+  {
+    if (itr->sound != kInvalidSound)
+    {
+      count++;
+    }
+  }
+
+  return count;
+}
+
+void AudioManager::StartVoice(int channel, SoundId sound)
+{
+  if (_voices[channel].sound != kInvalidSound)
+  {
+    Mix_HaltChannel(channel);
+    ReleaseVoice(channel);
+  }
+
+  if (Mix_PlayChannel(channel, _sounds[sound].chunk, 0) < 0)
+  {
+    return;
+  }
+
+  _voices[channel].sound = sound;
+  _voices[channel].startOrder = _startCounter++;
+  _sounds[sound].instances++;
+}
+
+void AudioManager::ReleaseVoice(int channel)
+{
+  Voice &voice = _voices[channel];
+  if (voice.sound != kInvalidSound)
+  {
+    _sounds[voice.sound].instances--;
+    voice.sound = kInvalidSound;
+  }
+}
+
+int AudioManager::FindVoice(SoundId sound)
+{
+  // The oldest voice playing the sound, or the first free voice for kInvalidSound.
+  int found = -1;
+  for (int channel = 0; channel < (int)_voices.size(); channel++)
+  {
+    if (_voices[channel].sound != sound)
+    {
+      continue;
+    }
+
+    if (sound == kInvalidSound)
+    {
+      return channel;
+    }
+
+    if (found < 0 || _voices[channel].startOrder < _voices[found].startOrder)
+    {
+      found = channel;
+    }
+  }
+
+  return found;
+}
+
+int AudioManager::FindVoiceToSteal(int priority)
+{
+  // The oldest of the lowest priority voices, as long as it is less important than the new sound.
+  int found = -1;
+  for (int channel = 0; channel < (int)_voices.size(); channel++)
+  {
+    const Voice &voice = _voices[channel];
+    int voicePriority = _sounds[voice.sound].priority;
+    if (voicePriority >= priority)
+    {
+      continue;
+    }
+
+    if (found < 0)
+    {
+      found = channel;
+      continue;
+    }
+
+    int foundPriority = _sounds[_voices[found].sound].priority;
+    if (voicePriority < foundPriority || (voicePriority == foundPriority && voice.startOrder < _voices[found].startOrder))
+    {
+      found = channel;
+    }
+  }
+
+  return found;
+}
\ No newline at end of file
@@ -0,0 +1,159 @@
+/**
+ * \class AudioManager
+ * \brief A singleton around SDL_mixer that decides which sounds get one of a fixed pool of voices.
+ *
+ * Play only queues a trigger. Once per update the queued triggers are resolved: a sound triggered several
+ * times in the same update plays once, a sound already playing as many times as it is allowed restarts its
+ * oldest instance instead of taking another voice, and when every voice is busy a trigger may steal the
+ * voice of a lower priority sound. Important cues therefore always find a voice, however many minor
+ * sounds fire at once.
+ */
+
+#pragma once
+#include "AssetLoader.h"
+#include "ResourceManager.h"
+#include <SDL_stdinc.h>
+#include <future>
+#include <string>
+#include <vector>
+
+struct Mix_Chunk;
+
+typedef int SoundId;
+static const SoundId kInvalidSound = -1;
+
+class AudioManager
+{
+public:
+  /**
+  * \fn static AudioManager* AudioManager::GetInstance()
+  * \brief A static method to get the single instance of this class.
+  * \return The single AudioManager instance.
+  */
+  static AudioManager* GetInstance();
+
+  /**
+  * \fn static void AudioManager::DestroyInstance()
+  * \brief A static method to destroy the single instance of this class, closing the audio device.
+  */
+  static void DestroyInstance();
+
+  /**
+  * \fn AudioManager::~AudioManager()
+  * \brief Frees every sound and closes the audio device.
+  */
+  ~AudioManager();
+
+  /**
+  * \fn bool AudioManager::Open(int frequency, Uint16 format, int channels, int chunkSize, int voices)
+  * \brief Opens the audio device.
+  * \param frequency, format, channels, chunkSize The output format, as given to Mix_OpenAudio.
+  * \param voices The number of sounds that can play at once.
+  * \return Whether or not the device could be opened, see Mix_GetError when it couldn't.
+  */
+  bool Open(int frequency, Uint16 format, int channels, int chunkSize, int voices);
+
+  /**
+  * \fn void AudioManager::Close()
+  * \brief Stops every voice, frees every sound and closes the audio device.
+  */
+  void Close();
+
+  /**
+  * \fn SoundId AudioManager::LoadSound(const char *path, int priority, int maxInstances)
+  * \brief Loads a WAV file.
+  * \param path The file to load.
+  * \param priority Sounds with a higher priority can take the voice of a lower priority sound.
+  * \param maxInstances How many instances of the sound may play at once.
+  * \return The id of the sound, kInvalidSound if the file couldn't be loaded (see Mix_GetError).
+  */
+  SoundId LoadSound(const char *path, int priority, int maxInstances);
+
+  /**
+  * \fn SoundId AudioManager::LoadSoundAsync(const char *path, int priority, int maxInstances, AssetLoader *loader)
+  * \brief Starts decoding a WAV file on the loader's threads and returns its id straight away.
+  * Until the data arrives the sound is silent: playing it does nothing. If the file can't be loaded the
+  * error is logged and the sound stays silent.
+  * \param path The file to load.
+  * \param priority Sounds with a higher priority can take the voice of a lower priority sound.
+  * \param maxInstances How many instances of the sound may play at once.
+  * \param loader The loader to decode with.
+  * \return The id of the sound, kInvalidSound if the audio device isn't open.
+  */
+  SoundId LoadSoundAsync(const char *path, int priority, int maxInstances, AssetLoader *loader);
+
+  /**
+  * \fn bool AudioManager::IsLoading() const
+  * \brief Gets whether or not any sound is still being decoded.
+  */
+  bool IsLoading() const;
+
+  /**
+  * \fn void AudioManager::Play(SoundId sound)
+  * \brief Queues the sound to play at the next Update. Cheap, any number of triggers can be queued.
+  */
+  void Play(SoundId sound);
+
+  /**
+  * \fn void AudioManager::Update()
+  * \brief Frees the voices of finished sounds and starts the sounds triggered since the last update.
+  */
+  void Update();
+
+  int GetActiveVoiceCount() const;
+
+protected:
+  /**
+  * \fn AudioManager::AudioManager()
+  * \brief Standard constructor for AudioManager.
+  */
+  AudioManager();
+
+  struct Sound
+  {
+    // The reference into the shared sound cache keeps chunk alive, NULL while loading.
+    SoundCache::Handle handle;
+    Mix_Chunk *chunk;
+    int priority;
+    int maxInstances;
+
+    // Voices currently playing the sound.
+    int instances;
+
+    // Set by Play, so repeated triggers in one update queue the sound once.
+    bool isTriggered;
+  };
+
+  // A sound whose data is still being decoded.
+  struct PendingSound
+  {
+    SoundId sound;
+    std::string path;
+    std::shared_future<AssetResult<Mix_Chunk> > result;
+  };
+
+  struct Voice
+  {
+    SoundId sound;
+
+    // Order the voice was started in, used to find the oldest voice.
+    Uint32 startOrder;
+  };
+
+  SoundId AddSound(SoundCache::Handle handle, int priority, int maxInstances);
+  void CollectLoadedSounds(bool wait);
+  void StartVoice(int channel, SoundId sound);
+  void ReleaseVoice(int channel);
+  int FindVoice(SoundId sound);
+  int FindVoiceToSteal(int priority);
+
+  static AudioManager *_instance;
+
+  bool _isOpen;
+  Uint32 _startCounter;
+
+  std::vector<Sound> _sounds;
+  std::vector<Voice> _voices;
+  std::vector<SoundId> _triggered;
+  std::vector<PendingSound> _pending;
+};
\ No newline at end of file
@@ -0,0 +1,556 @@
+#include "ChunkedStateGrid.h"
+#include "ThreadPool.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+ChunkedStateGrid::ChunkedStateGrid() :
+_rows(0),
+_columns(0),
+_chunkRows(0),
+_chunkColumns(0),
+_defaultState(0),
+_generator(nullptr),
+_threadPool(nullptr),
+_focusChunkRow(-1),
+_focusChunkColumn(-1),
+_focusRadius(-1),
+_listenerCount(0),
+_chunkListenerCount(0)
+{
+  for (int i = 0; i < kMaxStates; i++)
+  {
+    _counts[i] = 0;
+  }
+}
+
+void ChunkedStateGrid::SetGenerator(ChunkGenerator generator, ThreadPool *threadPool)
+{
+  _generator = generator;
+  _threadPool = threadPool;
+}
+
+void ChunkedStateGrid::Resize(int rows, int columns, Uint8 defaultState)
+{
+  EvictAll();
+
+  // Generation still running for the old grid finishes into futures nobody reads.
+  _pending.clear();
+  _evicted.clear();
+  _counted.clear();
+
+  _rows = rows;
+  _columns = columns;
+  _chunkRows = (rows + kChunkSize - 1) / kChunkSize;
+  _chunkColumns = (columns + kChunkSize - 1) / kChunkSize;
+  _defaultState = defaultState;
+
+  for (int i = 0; i < kMaxStates; i++)
+  {
+    _counts[i] = 0;
+  }
+  _counts[defaultState] = rows * columns;
+
+  _focusChunkRow = -1;
+  _focusChunkColumn = -1;
+  _focusRadius = -1;
+}
+
+void ChunkedStateGrid::SetFocus(int row, int column, int radius)
+{
+  if (_rows == 0 || _columns == 0)
+  {
+    return;
+  }
+
+  // A focus off the edge loads the chunks along that edge.
+  row = (row < 0) ? 0 : (row >= _rows) ? _rows - 1 : row;
+  column = (column < 0) ? 0 : (column >= _columns) ? _columns - 1 : column;
+
+  int focusRow = row / kChunkSize;
+  int focusColumn = column / kChunkSize;
+  if (focusRow == _focusChunkRow && focusColumn == _focusChunkColumn && radius == _focusRadius)
+  {
+    return;
+  }
+
+  // Chunks get one chunk of slack before they go, so walking back and forth over a chunk border doesn't thrash.
+  for (int i = (int)_loaded.size() - 1; i >= 0; i--)
+  {
+    if (abs(_loaded[i].chunkRow - focusRow) > radius + 1 || abs(_loaded[i].chunkColumn - focusColumn) > radius + 1)
+    {
+      Evict(i, true);
+    }
+  }
+
+  for (auto itr = _pending.begin(); itr != _pending.end();)
+  {
+    if (abs(itr->chunkRow - focusRow) > radius + 1 || abs(itr->chunkColumn - focusColumn) > radius + 1)
+    {
+      itr = _pending.erase(itr);
+    }
+    else
+    {
+      itr++;
+    }
+  }
+
+  // Ring by ring, so the workers get to the nearest chunks first.
+  for (int distance = 0; distance <= radius; distance++)
+  {
+    for (int chunkRow = focusRow - distance; chunkRow <= focusRow + distance; chunkRow++)
+    {
+      for (int chunkColumn = focusColumn - distance; chunkColumn <= focusColumn + distance; chunkColumn++)
+      {
+        bool isOnRing = abs(chunkRow - focusRow) == distance || abs(chunkColumn - focusColumn) == distance;
+        if (isOnRing && chunkRow >= 0 && chunkRow < _chunkRows && chunkColumn >= 0 && chunkColumn < _chunkColumns)
+        {
+          Request(chunkRow, chunkColumn);
+        }
+      }
+    }
+  }
+
+  // The chunk under the focus can't wait for the next Update.
+  if (FindLoaded(focusRow, focusColumn) == nullptr)
+  {
+    Uint32 key = GetKey(focusRow, focusColumn);
+    for (auto itr = _pending.begin(); itr != _pending.end(); itr++)
+    {
+      if (itr->key == key)
+      {
+        InstallPending(*itr);
+        _pending.erase(itr);
+        break;
+      }
+    }
+  }
+
+  _focusChunkRow = focusRow;
+  _focusChunkColumn = focusColumn;
+  _focusRadius = radius;
+}
+
+void ChunkedStateGrid::Update()
+{
+  for (auto itr = _pending.begin(); itr != _pending.end();)
+  {
+    if (itr->states.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+      itr++;
+      continue;
+    }
+
+    InstallPending(*itr);
+    itr = _pending.erase(itr);
+  }
+}
+
+bool ChunkedStateGrid::Set(int row, int column, Uint8 state)
+{
+  if (Contains(row, column) == false)
+  {
+    return false;
+  }
+
+  LoadedChunk *chunk = FindLoaded(row / kChunkSize, column / kChunkSize);
+  if (chunk == nullptr)
+  {
+    return false;
+  }
+
+  Uint8 &cell = chunk->states[(row % kChunkSize) * kChunkSize + column % kChunkSize];
+  if (cell == state)
+  {
+    return false;
+  }
+
+  StateChange change = { row, column, cell, state };
+  _counts[cell]--;
+  _counts[state]++;
+  cell = state;
+  chunk->isModified = true;
+
+  for (int i = 0; i < _listenerCount; i++)
+  {
+    _listeners[i](change);
+  }
+
+  return true;
+}
+
+Uint8 ChunkedStateGrid::Get(int row, int column) const
+{
+  if (Contains(row, column) == false)
+  {
+    return kNotLoaded;
+  }
+
+  const LoadedChunk *chunk = FindLoaded(row / kChunkSize, column / kChunkSize);
+  if (chunk == nullptr)
+  {
+    return kNotLoaded;
+  }
+
+  return chunk->states[(row % kChunkSize) * kChunkSize + column % kChunkSize];
+}
+
+const Uint8* ChunkedStateGrid::GetChunkStates(int chunkRow, int chunkColumn) const
+{
+  const LoadedChunk *chunk = FindLoaded(chunkRow, chunkColumn);
+  return (chunk != nullptr) ? &chunk->states[0] : nullptr;
+}
+
+int ChunkedStateGrid::GetCount(Uint8 state) const
+{
+  return _counts[state];
+}
+
+int ChunkedStateGrid::GetRows() const
+{
+  return _rows;
+}
+
+int ChunkedStateGrid::GetColumns() const
+{
+  return _columns;
+}
+
+bool ChunkedStateGrid::Contains(int row, int column) const
+{
+  return row >= 0 && row < _rows && column >= 0 && column < _columns;
+}
+
+int ChunkedStateGrid::GetLoadedChunkCount() const
+{
+  return (int)_loaded.size();
+}
+
+int ChunkedStateGrid::GetPendingChunkCount() const
+{
+  return (int)_pending.size();
+}
+
+void ChunkedStateGrid::Save(Snapshot &snapshot) const
+{
+  Sint32 rows = _rows;
+  Sint32 columns = _columns;
+  snapshot.Write(rows);
+  snapshot.Write(columns);
+  snapshot.Write(_defaultState);
+  snapshot.Write(_counts);
+
+  Uint32 countedCount = (Uint32)_counted.size();
+  snapshot.Write(countedCount);
+  for (auto itr = _counted.begin(); itr != _counted.end(); itr++)
+  {
+    snapshot.Write(*itr);
+  }
+
+  Uint32 changedCount = (Uint32)_evicted.size();
+  for (auto itr = _loaded.begin(); itr != _loaded.end(); itr++)
+  {
+    changedCount += itr->isModified ? 1 : 0;
+  }
+
+  snapshot.Write(changedCount);
+  for (auto itr = _evicted.begin(); itr != _evicted.end(); itr++)
+  {
+    snapshot.Write(itr->first);
+    snapshot.Write(&itr->second[0], kChunkCells);
+  }
+  for (auto itr = _loaded.begin(); itr != _loaded.end(); itr++)
+  {
+    if (itr->isModified)
+    {
+      snapshot.Write(itr->key);
+      snapshot.Write(&itr->states[0], kChunkCells);
+    }
+  }
+}
+
+bool ChunkedStateGrid::Restore(Snapshot &snapshot)
+{
+  Sint32 rows, columns;
+  Uint8 defaultState;
+  if (snapshot.Read(rows) == false || snapshot.Read(columns) == false || snapshot.Read(defaultState) == false)
+  {
+    return false;
+  }
+
+  if (rows != _rows || columns != _columns || defaultState != _defaultState)
+  {
+    Resize(rows, columns, defaultState);
+  }
+
+  Uint32 countedCount;
+  if (snapshot.Read(_counts) == false || snapshot.Read(countedCount) == false)
+  {
+    return false;
+  }
+
+  _counted.clear();
+  for (Uint32 i = 0; i < countedCount; i++)
+  {
+    Uint32 key;
+    if (snapshot.Read(key) == false)
+    {
+      return false;
+    }
+    _counted.insert(key);
+  }
+
+  Uint32 changedCount;
+  if (snapshot.Read(changedCount) == false)
+  {
+    return false;
+  }
+
+  _evicted.clear();
+  for (Uint32 i = 0; i < changedCount; i++)
+  {
+    Uint32 key;
+    std::vector<Uint8> states(kChunkCells);
+    if (snapshot.Read(key) == false || snapshot.Read(&states[0], kChunkCells) == false)
+    {
+      return false;
+    }
+    _evicted[key].swap(states);
+  }
+
+  // Loaded chunks take their saved changes, lose changes made since, or are left alone.
+  for (int i = (int)_loaded.size() - 1; i >= 0; i--)
+  {
+    LoadedChunk &chunk = _loaded[i];
+    auto saved = _evicted.find(chunk.key);
+    if (saved != _evicted.end())
+    {
+      chunk.states.swap(saved->second);
+      chunk.isModified = true;
+      _evicted.erase(saved);
+      NotifyChunk(chunk.chunkRow, chunk.chunkColumn, true);
+    }
+    else if (chunk.isModified)
+    {
+      Evict(i, false);
+    }
+    else if (_counted.insert(chunk.key).second)
+    {
+      // Generated after the snapshot was taken, so the saved counts still have it in the default state.
+      int chunkRows = (_rows - chunk.chunkRow * kChunkSize < kChunkSize) ? _rows - chunk.chunkRow * kChunkSize : kChunkSize;
+      int chunkColumns = (_columns - chunk.chunkColumn * kChunkSize < kChunkSize) ? _columns - chunk.chunkColumn * kChunkSize : kChunkSize;
+      for (int row = 0; row < chunkRows; row++)
+      {
+        for (int column = 0; column < chunkColumns; column++)
+        {
+          _counts[_defaultState]--;
+          _counts[chunk.states[row * kChunkSize + column]]++;
+        }
+      }
+    }
+  }
+
+  // Make the next SetFocus reload whatever was evicted.
+  _focusChunkRow = -1;
+  _focusChunkColumn = -1;
+  _focusRadius = -1;
+  return true;
+}
+
+void ChunkedStateGrid::AddListener(const StateDelegate &listener)
+{
+  for (int i = 0; i < _listenerCount; i++)
+  {
+    if (_listeners[i] == listener)
+    {
+      return;
+    }
+  }
+
+  if (_listenerCount == kMaxListeners)
+  {
+    printf("ChunkedStateGrid: no room for another listener\n");
+    return;
+  }
+
+  _listeners[_listenerCount++] = listener;
+}
+
+void ChunkedStateGrid::AddChunkListener(const ChunkDelegate &listener)
+{
+  for (int i = 0; i < _chunkListenerCount; i++)
+  {
+    if (_chunkListeners[i] == listener)
+    {
+      return;
+    }
+  }
+
+  if (_chunkListenerCount == kMaxListeners)
+  {
+    printf("ChunkedStateGrid: no room for another chunk listener\n");
+    return;
+  }
+
+  _chunkListeners[_chunkListenerCount++] = listener;
+}
+
+Uint32 ChunkedStateGrid::GetKey(int chunkRow, int chunkColumn) const
+{
+  return (Uint32)(chunkRow * _chunkColumns + chunkColumn);
+}
+
+ChunkedStateGrid::LoadedChunk* ChunkedStateGrid::FindLoaded(int chunkRow, int chunkColumn)
+{
+  auto itr = _loadedIndices.find(GetKey(chunkRow, chunkColumn));
+  return (itr != _loadedIndices.end()) ? &_loaded[itr->second] : nullptr;
+}
+
+const ChunkedStateGrid::LoadedChunk* ChunkedStateGrid::FindLoaded(int chunkRow, int chunkColumn) const
+{
+  auto itr = _loadedIndices.find(GetKey(chunkRow, chunkColumn));
+  return (itr != _loadedIndices.end()) ? &_loaded[itr->second] : nullptr;
+}
+
+void ChunkedStateGrid::Request(int chunkRow, int chunkColumn)
+{
+  Uint32 key = GetKey(chunkRow, chunkColumn);
+  if (_loadedIndices.count(key) > 0)
+  {
+    return;
+  }
+
+  for (auto itr = _pending.begin(); itr != _pending.end(); itr++)
+  {
+    if (itr->key == key)
+    {
+      return;
+    }
+  }
+
+  auto evicted = _evicted.find(key);
+  if (evicted != _evicted.end())
+  {
+    Install(key, chunkRow, chunkColumn, evicted->second, true);
+    _evicted.erase(evicted);
+    return;
+  }
+
+  ChunkGenerator generator = _generator;
+  int firstRow = chunkRow * kChunkSize;
+  int firstColumn = chunkColumn * kChunkSize;
+  int rows = (_rows - firstRow < kChunkSize) ? _rows - firstRow : kChunkSize;
+  int columns = (_columns - firstColumn < kChunkSize) ? _columns - firstColumn : kChunkSize;
+  Uint8 defaultState = _defaultState;
+  auto generate = [=]()
+  {
+    std::vector<Uint8> states(kChunkCells, defaultState);
+    if (generator != nullptr)
+    {
+      generator(firstRow, firstColumn, rows, columns, &states[0]);
+    }
+    return states;
+  };
+
+  // A chunk of default states isn't worth a trip through the pool.
+  if (_threadPool == nullptr || generator == nullptr)
+  {
+    std::vector<Uint8> states = generate();
+    Install(key, chunkRow, chunkColumn, states, false);
+    return;
+  }
+
+  _pending.emplace_back();
+  PendingChunk &pending = _pending.back();
+  pending.key = key;
+  pending.chunkRow = chunkRow;
+  pending.chunkColumn = chunkColumn;
+  pending.states = _threadPool->Submit(generate);
+}
+
+void ChunkedStateGrid::Install(Uint32 key, int chunkRow, int chunkColumn, std::vector<Uint8> &states, bool isModified)
+{
+  // The first time a chunk shows up its cells move out of the default state they were counted in.
+  if (_counted.insert(key).second)
+  {
+    int rows = (_rows - chunkRow * kChunkSize < kChunkSize) ? _rows - chunkRow * kChunkSize : kChunkSize;
+    int columns = (_columns - chunkColumn * kChunkSize < kChunkSize) ? _columns - chunkColumn * kChunkSize : kChunkSize;
+    for (int row = 0; row < rows; row++)
+    {
+      for (int column = 0; column < columns; column++)
+      {
+        _counts[_defaultState]--;
+        _counts[states[row * kChunkSize + column]]++;
+      }
+    }
+  }
+
+  _loaded.push_back(LoadedChunk());
+  LoadedChunk &chunk = _loaded.back();
+  chunk.key = key;
+  chunk.chunkRow = chunkRow;
+  chunk.chunkColumn = chunkColumn;
+  chunk.isModified = isModified;
+  chunk.states.swap(states);
+  _loadedIndices[key] = (int)_loaded.size() - 1;
+
+  NotifyChunk(chunkRow, chunkColumn, true);
+}
+
+void ChunkedStateGrid::InstallPending(PendingChunk &pending)
+{
+  // A snapshot restored while the chunk was generating may hold changes to it.
+  auto evicted = _evicted.find(pending.key);
+  if (evicted != _evicted.end())
+  {
+    Install(pending.key, pending.chunkRow, pending.chunkColumn, evicted->second, true);
+    _evicted.erase(evicted);
+    return;
+  }
+
+  std::vector<Uint8> states = pending.states.get();
+  Install(pending.key, pending.chunkRow, pending.chunkColumn, states, false);
+}
+
+void ChunkedStateGrid::Evict(int index, bool keepChanges)
+{
+  LoadedChunk &chunk = _loaded[index];
+  NotifyChunk(chunk.chunkRow, chunk.chunkColumn, false);
+
+  if (chunk.isModified && keepChanges)
+  {
+    _evicted[chunk.key].swap(chunk.states);
+  }
+
+  _loadedIndices.erase(chunk.key);
+  if (index != (int)_loaded.size() - 1)
+  {
+    LoadedChunk &last = _loaded.back();
+    chunk.key = last.key;
+    chunk.chunkRow = last.chunkRow;
+    chunk.chunkColumn = last.chunkColumn;
+    chunk.isModified = last.isModified;
+    chunk.states.swap(last.states);
+    _loadedIndices[chunk.key] = index;
+  }
+  _loaded.pop_back();
+}
+
+void ChunkedStateGrid::EvictAll()
+{
+  for (auto itr = _loaded.begin(); itr != _loaded.end(); itr++)
+  {
+    NotifyChunk(itr->chunkRow, itr->chunkColumn, false);
+  }
+
+  _loaded.clear();
+  _loadedIndices.clear();
+}
+
+void ChunkedStateGrid::NotifyChunk(int chunkRow, int chunkColumn, bool isLoaded)
+{
+  ChunkChange change = { chunkRow, chunkColumn, isLoaded };
+  for (int i = 0; i < _chunkListenerCount; i++)
+  {
+    _chunkListeners[i](change);
+  }
+}
\ No newline at end of file
@@ -0,0 +1,234 @@
+/**
+ * \class ChunkedStateGrid
+ * \brief A grid of small per-cell states for worlds too big to keep in memory. The grid is split into square chunks
+ * that are loaded around a focus point, eg. the player, and evicted when the focus moves away. Chunks start out in
+ * the default state, an optional generator can fill them in on the thread pool.
+ *
+ * A chunk nobody changed is simply generated again when it comes back into range, so only chunks with changes are
+ * kept after eviction. Memory therefore follows the area around the focus and the area that was changed, never the
+ * size of the grid. Like StateGrid it keeps running counts of the cells in each state over the whole grid and tells
+ * listeners about every change, and it tells chunk listeners whenever a chunk is loaded or evicted.
+ */
+
+#pragma once
+#include "Delegate.h"
+#include "Snapshot.h"
+#include "StateGrid.h"
+#include <SDL_stdinc.h>
+#include <future>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class ThreadPool;
+
+struct ChunkChange
+{
+  int chunkRow, chunkColumn;
+
+  // false when the chunk was evicted
+  bool isLoaded;
+};
+
+typedef Delegate<const ChunkChange &> ChunkDelegate;
+
+/**
+ * Fills in the states of one chunk, row by row with kChunkSize cells per row, over the default state. It runs on a
+ * worker thread, so it may only use its arguments, and it has to give a chunk the same states every time it is called.
+ */
+typedef void (*ChunkGenerator)(int firstRow, int firstColumn, int rows, int columns, Uint8 *states);
+
+class ChunkedStateGrid
+{
+public:
+  static const int kChunkSize = 16;
+  static const int kMaxStates = StateGrid::kMaxStates;
+  static const int kMaxListeners = 4;
+
+  // What Get returns for cells whose chunk isn't loaded.
+  static const Uint8 kNotLoaded = 0xFF;
+
+  /**
+  * \fn ChunkedStateGrid::ChunkedStateGrid()
+  * \brief Creates an empty grid that generates on the calling thread.
+  */
+  ChunkedStateGrid();
+
+  /**
+  * \fn void ChunkedStateGrid::SetGenerator(ChunkGenerator generator, ThreadPool *threadPool)
+  * \brief Sets the function chunks are generated with, and the pool it runs on. Without a generator every chunk
+  * starts out in the default state and is filled in on the thread calling SetFocus.
+  * \param threadPool The pool to generate on, nullptr to generate on the thread calling SetFocus.
+  */
+  void SetGenerator(ChunkGenerator generator, ThreadPool *threadPool);
+
+  /**
+  * \fn void ChunkedStateGrid::Resize(int rows, int columns, Uint8 defaultState)
+  * \brief Evicts every chunk, forgets every change and starts a new grid. Nothing is generated until SetFocus.
+  * \param defaultState The state cells of chunks that were never generated are counted in. The counts are exact
+  * once every chunk was generated, or at any time if the generator only produces this state.
+  */
+  void Resize(int rows, int columns, Uint8 defaultState);
+
+  /**
+  * \fn void ChunkedStateGrid::SetFocus(int row, int column, int radius)
+  * \brief Loads the chunks within the given number of chunks of a cell, nearest first, and evicts the ones more
+  * than one chunk further out. The chunk holding the cell itself is always loaded when this returns, if need be by
+  * waiting for it.
+  */
+  void SetFocus(int row, int column, int radius);
+
+  /**
+  * \fn void ChunkedStateGrid::Update()
+  * \brief Loads the chunks whose generation finished since the last call, without waiting. Call once per tick.
+  */
+  void Update();
+
+  /**
+  * \fn bool ChunkedStateGrid::Set(int row, int column, Uint8 state)
+  * \brief Changes the state of a cell, updating the counts and telling the listeners.
+  * \return true if the cell was in a different state, false if nothing changed or the chunk isn't loaded.
+  */
+  bool Set(int row, int column, Uint8 state);
+
+  /**
+  * \fn Uint8 ChunkedStateGrid::Get(int row, int column) const
+  * \brief Gets the state of a cell, kNotLoaded if its chunk isn't loaded or the cell is outside the grid.
+  */
+  Uint8 Get(int row, int column) const;
+
+  /**
+  * \fn const Uint8* ChunkedStateGrid::GetChunkStates(int chunkRow, int chunkColumn) const
+  * \brief Gets the states of a loaded chunk, kChunkSize rows of kChunkSize cells. Cells past the edge of the grid
+  * are left over from the generator and mean nothing.
+  * \return nullptr if the chunk isn't loaded.
+  */
+  const Uint8* GetChunkStates(int chunkRow, int chunkColumn) const;
+
+  int GetCount(Uint8 state) const;
+  int GetRows() const;
+  int GetColumns() const;
+  bool Contains(int row, int column) const;
+
+  int GetLoadedChunkCount() const;
+  int GetPendingChunkCount() const;
+
+  /**
+  * \fn void ChunkedStateGrid::Save(Snapshot &snapshot) const
+  * \brief Appends the size, counts and every changed chunk to a snapshot. Unchanged chunks aren't saved, they can
+  * be generated again.
+  */
+  void Save(Snapshot &snapshot) const;
+
+  /**
+  * \fn bool ChunkedStateGrid::Restore(Snapshot &snapshot)
+  * \brief Reads back what Save wrote. Loaded chunks are kept and refreshed where possible; chunk listeners are
+  * told about every chunk whose contents were replaced, as if it was loaded again.
+  * \return false if the snapshot ran out.
+  */
+  bool Restore(Snapshot &snapshot);
+
+  /**
+  * \fn void ChunkedStateGrid::AddListener<T, Method>(T *target)
+  * \brief Calls the given member function on the target whenever a cell changes state.
+  */
+  template <class T, void (T::*Method)(const StateChange &)>
+  void AddListener(T *target)
+  {
+    AddListener(StateDelegate::FromMethod<T, Method>(target));
+  }
+
+  void AddListener(const StateDelegate &listener);
+
+  /**
+  * \fn void ChunkedStateGrid::AddChunkListener<T, Method>(T *target)
+  * \brief Calls the given member function on the target whenever a chunk is loaded or evicted.
+  * eg. AddChunkListener<WorldMesh, &WorldMesh::OnChunkChanged>(mesh);
+  */
+  template <class T, void (T::*Method)(const ChunkChange &)>
+  void AddChunkListener(T *target)
+  {
+    AddChunkListener(ChunkDelegate::FromMethod<T, Method>(target));
+  }
+
+  void AddChunkListener(const ChunkDelegate &listener);
+
+protected:
+  struct LoadedChunk
+  {
+    Uint32 key;
+    int chunkRow, chunkColumn;
+    bool isModified;
+    std::vector<Uint8> states;
+  };
+
+  struct PendingChunk
+  {
+    Uint32 key;
+    int chunkRow, chunkColumn;
+    std::future<std::vector<Uint8> > states;
+  };
+
+  static const int kChunkCells = kChunkSize * kChunkSize;
+
+  Uint32 GetKey(int chunkRow, int chunkColumn) const;
+  LoadedChunk* FindLoaded(int chunkRow, int chunkColumn);
+  const LoadedChunk* FindLoaded(int chunkRow, int chunkColumn) const;
+
+  /**
+  * \fn void ChunkedStateGrid::Request(int chunkRow, int chunkColumn)
+  * \brief Loads a chunk from its saved changes, or starts generating it, unless it is loaded or pending already.
+  */
+  void Request(int chunkRow, int chunkColumn);
+
+  /**
+  * \fn void ChunkedStateGrid::Install(Uint32 key, int chunkRow, int chunkColumn, std::vector<Uint8> &states, bool isModified)
+  * \brief Makes a chunk loaded, taking the contents of the states vector, and counts it the first time it appears.
+  */
+  void Install(Uint32 key, int chunkRow, int chunkColumn, std::vector<Uint8> &states, bool isModified);
+
+  /**
+  * \fn void ChunkedStateGrid::InstallPending(PendingChunk &pending)
+  * \brief Installs a chunk that finished generating, or the changes a restored snapshot holds for it instead,
+  * waiting for it if need be. The caller removes it from the pending list.
+  */
+  void InstallPending(PendingChunk &pending);
+
+  /**
+  * \fn void ChunkedStateGrid::Evict(int index, bool keepChanges)
+  * \brief Unloads a chunk, keeping its states if it was changed and keepChanges is set.
+  */
+  void Evict(int index, bool keepChanges);
+
+  void EvictAll();
+  void NotifyChunk(int chunkRow, int chunkColumn, bool isLoaded);
+
+  int _rows, _columns;
+  int _chunkRows, _chunkColumns;
+  Uint8 _defaultState;
+  int _counts[kMaxStates];
+
+  ChunkGenerator _generator;
+  ThreadPool *_threadPool;
+
+  // The chunk the focus was last in and the radius loaded around it, -1 when nothing was loaded yet.
+  int _focusChunkRow, _focusChunkColumn, _focusRadius;
+
+  std::vector<LoadedChunk> _loaded;
+  std::unordered_map<Uint32, int> _loadedIndices;
+  // A list, so the futures never have to be moved.
+  std::list<PendingChunk> _pending;
+
+  // States of the chunks that were changed and then evicted.
+  std::unordered_map<Uint32, std::vector<Uint8> > _evicted;
+
+  // Every chunk that was generated at least once, so it's only counted once.
+  std::unordered_set<Uint32> _counted;
+
+  StateDelegate _listeners[kMaxListeners];
+  int _listenerCount;
+
+  ChunkDelegate _chunkListeners[kMaxListeners];
+  int _chunkListenerCount;
+};
\ No newline at end of file
@@ -0,0 +1,41 @@
+/**
+ * CookedFormats.h
+ * Purpose: The runtime-ready asset formats the AssetCooker tool writes into packed archives.
+ *
+ * Cooked assets are laid out exactly as the engine consumes them, so loading one is a pointer into the archive
+ * mapping (or a memcpy) instead of a parse and a conversion. A cooked asset starts with a small header naming
+ * its format; all values are little endian.
+ */
+
+#pragma once
+#include <SDL_stdinc.h>
+
+static const Uint32 kCookedSoundMagic = 0x4E534243; // "CBSN"
+static const Uint32 kCookedMeshMagic = 0x534D4243; // "CBMS"
+
+/**
+ * Header of a cooked sound, followed by byteCount bytes of PCM already in the mixer's output format, so
+ * SDL_mixer can play it in place with Mix_QuickLoad_RAW. Cooked sounds are stored uncompressed.
+ */
+struct CookedSoundHeader
+{
+  Uint32 magic;
+  Uint32 frequency;
+  Uint16 format;
+  Uint8 channels;
+  Uint8 reserved;
+  Uint32 byteCount;
+};
+
+/**
+ * Header of a cooked mesh. It is followed by three arrays, in the layout glVertexPointer, glColorPointer and
+ * glDrawElements read them: vertexCount positions (3 floats), vertexCount colours (4 floats), then indexCount
+ * Uint32 indices describing a triangle list with clockwise front faces.
+ */
+struct CookedMeshHeader
+{
+  Uint32 magic;
+  Uint32 vertexCount;
+  Uint32 indexCount;
+  Uint32 reserved;
+};
\ No newline at end of file
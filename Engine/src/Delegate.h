@@ -0,0 +1,96 @@
+/**
+ * \class Delegate
+ * \brief A callable reference to a free function, or to a member function bound to an object.
+ *
+ * Everything is stored inline (an object pointer and two function pointers), so delegates can be
+ * copied into fixed arrays without allocating. Two delegates compare equal when they call the same
+ * function on the same object, which is what callback removal relies on.
+ */
+
+#pragma once
+
+template <typename Arg>
+class Delegate
+{
+public:
+  typedef void(*Function)(Arg);
+
+  /**
+  * \fn Delegate::Delegate()
+  * \brief Creates an unbound delegate. Calling it does nothing.
+  */
+  Delegate() : _object(nullptr), _function(nullptr), _stub(nullptr) { }
+
+  /**
+  * \fn static Delegate Delegate::FromFunction(Function function)
+  * \brief Creates a delegate calling a free (or static) function.
+  * \param function The function to call.
+  */
+  static Delegate FromFunction(Function function)
+  {
+    Delegate delegate;
+    delegate._function = function;
+    delegate._stub = &FunctionStub;
+    return delegate;
+  }
+
+  /**
+  * \fn static Delegate Delegate::FromMethod<T, Method>(T *object)
+  * \brief Creates a delegate calling the given member function on the given object.
+  * The member function is a template argument, so the call is resolved at compile time.
+  * \param object The object to call the member function on. It must outlive the delegate.
+  */
+  template <class T, void (T::*Method)(Arg)>
+  static Delegate FromMethod(T *object)
+  {
+    Delegate delegate;
+    delegate._object = object;
+    delegate._stub = &MethodStub<T, Method>;
+    return delegate;
+  }
+
+  /**
+  * \fn void Delegate::operator()(Arg arg) const
+  * \brief Calls the bound function, if any.
+  */
+  void operator()(Arg arg) const
+  {
+    if (_stub != nullptr)
+    {
+      _stub(*this, arg);
+    }
+  }
+
+  bool IsBound() const
+  {
+    return _stub != nullptr;
+  }
+
+  bool operator==(const Delegate &other) const
+  {
+    return _object == other._object && _function == other._function && _stub == other._stub;
+  }
+
+  bool operator!=(const Delegate &other) const
+  {
+    return !(*this == other);
+  }
+
+private:
+  typedef void(*Stub)(const Delegate &, Arg);
+
+  static void FunctionStub(const Delegate &delegate, Arg arg)
+  {
+    delegate._function(arg);
+  }
+
+  template <class T, void (T::*Method)(Arg)>
+  static void MethodStub(const Delegate &delegate, Arg arg)
+  {
+    (static_cast<T *>(delegate._object)->*Method)(arg);
+  }
+
+  void *_object;
+  Function _function;
+  Stub _stub;
+};
\ No newline at end of file
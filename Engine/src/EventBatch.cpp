@@ -0,0 +1,80 @@
+#include "EventBatch.h"
+
+EventBatch::EventBatch() : _count(0) { }
+
+int EventBatch::Drain(bool pump)
+{
+  _count = 0;
+  if (pump)
+  {
+    SDL_PumpEvents();
+  }
+
+  // Peek in chunks so merged motion events free up room for more of the queue.
+  while (_count < kCapacity)
+  {
+    int peeked = SDL_PeepEvents(_events + _count, kCapacity - _count, SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+    if (peeked <= 0)
+    {
+      break;
+    }
+
+    int first = _count;
+    _count += peeked;
+    Compact(first);
+  }
+
+  return _count;
+}
+
+void EventBatch::Clear()
+{
+  _count = 0;
+}
+
+int EventBatch::GetCount() const
+{
+  return _count;
+}
+
+const SDL_Event& EventBatch::GetEvent(int index) const
+{
+  return _events[index];
+}
+
+void EventBatch::Compact(int first)
+{
+  int write = (first > 0) ? first - 1 : 0;
+  int read = (first > 0) ? first : 1;
+
+  for (; read < _count; read++)
+  {
+    SDL_Event &previous = _events[write];
+    const SDL_Event &current = _events[read];
+
+    // Fold motion into the previous motion event of the same mouse: latest position, summed deltas.
+    if (current.type == SDL_MOUSEMOTION && previous.type == SDL_MOUSEMOTION &&
+      current.motion.windowID == previous.motion.windowID && current.motion.which == previous.motion.which &&
+      current.motion.state == previous.motion.state)
+    {
+      int xrel = previous.motion.xrel + current.motion.xrel;
+      int yrel = previous.motion.yrel + current.motion.yrel;
+      previous = current;
+      previous.motion.xrel = xrel;
+      previous.motion.yrel = yrel;
+    }
+    else
+    {
+      write++;
+      if (write != read)
+      {
+        _events[write] = current;
+      }
+    }
+  }
+
+  if (_count > 0)
+  {
+    _count = write + 1;
+  }
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+/**
+ * \class EventBatch
+ * \brief A fixed-size buffer that takes every pending SDL event off the queue in one pass.
+ *
+ * Consecutive mouse motion events are merged while draining so a burst of motion costs a single dispatch.
+ */
+
+#pragma once
+#include <SDL_events.h>
+
+class EventBatch
+{
+public:
+  /**
+  * \fn EventBatch::EventBatch()
+  * \brief Creates an empty batch.
+  */
+  EventBatch();
+
+  /**
+  * \fn int EventBatch::Drain(bool pump)
+  * \brief Replaces the contents of the batch with every event waiting in the queue.
+  * \param pump Whether to pump SDL first, false when the caller just did.
+  * \return The number of events in the batch.
+  */
+  int Drain(bool pump = true);
+
+  /**
+  * \fn void EventBatch::Clear()
+  * \brief Empties the batch.
+  */
+  void Clear();
+
+  /**
+  * \fn int EventBatch::GetCount() const
+  * \brief Gets the number of events in the batch.
+  */
+  int GetCount() const;
+
+  /**
+  * \fn const SDL_Event& EventBatch::GetEvent(int index) const
+  * \brief Gets an event of the batch, in the order SDL queued them.
+  * \param index The index of the event, between 0 and GetCount() - 1.
+  */
+  const SDL_Event& GetEvent(int index) const;
+
+protected:
+  /**
+  * \fn void EventBatch::Compact(int first)
+  * \brief Merges runs of mouse motion events starting at the given index.
+  * \param first The index of the first event that hasn't been compacted yet.
+  */
+  void Compact(int first);
+
+  // Anything beyond this stays in SDL's queue until the next drain.
+  static const int kCapacity = 256;
+
+  SDL_Event _events[kCapacity];
+  int _count;
+};
\ No newline at end of file
@@ -0,0 +1,55 @@
+#include "EventBus.h"
+#include <stdio.h>
+
+EventBus::EventBus() :
+_isDispatching(false)
+{
+}
+
+EventBus::~EventBus()
+{
+  for (auto itr = _channels.begin(); itr != _channels.end(); itr++)
+  {
+    delete (*itr);
+  }
+}
+
+void EventBus::Dispatch()
+{
+  if (_isDispatching)
+  {
+    printf("EventBus: Dispatch called from a handler\n");
+    return;
+  }
+
+  _isDispatching = true;
+
+  // Every channel is swapped before any is delivered, so nothing a handler publishes is seen before the next
+  // dispatch. Channels created by a handler are picked up then too.
+  size_t channelCount = _channels.size();
+  for (size_t i = 0; i < channelCount; i++)
+  {
+    _channels[i]->Swap();
+  }
+
+  for (size_t i = 0; i < channelCount; i++)
+  {
+    _channels[i]->Deliver();
+  }
+
+  _isDispatching = false;
+}
+
+void EventBus::Clear()
+{
+  for (auto itr = _channels.begin(); itr != _channels.end(); itr++)
+  {
+    (*itr)->Clear();
+  }
+}
+
+int EventBus::NextTypeId()
+{
+  static int nextId = 0;
+  return nextId++;
+}
\ No newline at end of file
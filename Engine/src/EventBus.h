@@ -0,0 +1,229 @@
+/**
+ * \class EventBus
+ * \brief A typed event queue. Events are appended to a contiguous buffer per event type during the tick and
+ * handed to the handlers of that type in one batch when Dispatch is called.
+ *
+ * Each handler is called once per dispatch with every event of its type, in publish order, so a handler can
+ * consume the whole batch in a single pass. Events published by a handler go to the next dispatch, so handlers
+ * never run inside one another.
+ */
+
+#pragma once
+#include "Delegate.h"
+#include <stdio.h>
+#include <vector>
+
+template <typename T>
+class EventRange
+{
+public:
+  EventRange(const T *first, int count) : _first(first), _count(count) { }
+
+  int GetCount() const { return _count; }
+  const T& operator[](int index) const { return _first[index]; }
+
+  const T* begin() const { return _first; }
+  const T* end() const { return _first + _count; }
+
+private:
+  const T *_first;
+  int _count;
+};
+
+class EventBus
+{
+public:
+  static const int kMaxHandlers = 4;
+
+  /**
+  * \fn EventBus::EventBus()
+  * \brief Creates a bus with no channels.
+  */
+  EventBus();
+
+  /**
+  * \fn EventBus::~EventBus()
+  * \brief Frees every channel and the events still queued on them.
+  */
+  ~EventBus();
+
+  /**
+  * \fn void EventBus::Publish<T>(const T &event)
+  * \brief Queues an event for the next dispatch. Events nobody handles are dropped straight away.
+  */
+  template <typename T>
+  void Publish(const T &event)
+  {
+    Channel<T> *channel = GetChannel<T>();
+    if (channel->handlerCount > 0)
+    {
+      channel->pending.push_back(event);
+    }
+  }
+
+  /**
+  * \fn void EventBus::Subscribe<T, H, Method>(H *handler)
+  * \brief Calls the given member function with every batch of T events. Channels are dispatched in the order
+  * their first handler subscribed. Subscribing twice does nothing.
+  * eg. Subscribe<TileVisitedEvent, Game, &Game::OnTilesVisited>(this);
+  */
+  template <typename T, class H, void (H::*Method)(const EventRange<T> &)>
+  void Subscribe(H *handler)
+  {
+    GetChannel<T>()->Subscribe(Delegate<const EventRange<T> &>::template FromMethod<H, Method>(handler));
+  }
+
+  template <typename T, class H, void (H::*Method)(const EventRange<T> &)>
+  void Unsubscribe(H *handler)
+  {
+    GetChannel<T>()->Unsubscribe(Delegate<const EventRange<T> &>::template FromMethod<H, Method>(handler));
+  }
+
+  /**
+  * \fn void EventBus::Register<T>()
+  * \brief Creates the channel of an event type ahead of its first use. Type ids are handed out on first use without
+  * locking, so when buses are used on several threads, register every event type from one thread first.
+  */
+  template <typename T>
+  void Register()
+  {
+    GetChannel<T>();
+  }
+
+  /**
+  * \fn void EventBus::Dispatch()
+  * \brief Hands every queued event to its handlers, one channel at a time. Not to be called from a handler.
+  */
+  void Dispatch();
+
+  /**
+  * \fn void EventBus::Clear()
+  * \brief Drops every queued event without dispatching it. Handlers stay subscribed.
+  */
+  void Clear();
+
+protected:
+  // Only reached once per channel per dispatch, never per event.
+  class ChannelBase
+  {
+  public:
+    virtual ~ChannelBase() { }
+    virtual void Swap() = 0;
+    virtual void Deliver() = 0;
+    virtual void Clear() = 0;
+  };
+
+  template <typename T>
+  class Channel : public ChannelBase
+  {
+  public:
+    typedef Delegate<const EventRange<T> &> Handler;
+
+    Channel() : handlerCount(0) { }
+
+    void Subscribe(const Handler &handler)
+    {
+      for (int i = 0; i < handlerCount; i++)
+      {
+        if (handlers[i] == handler)
+        {
+          return;
+        }
+      }
+
+      if (handlerCount == kMaxHandlers)
+      {
+        printf("EventBus: no room for another handler\n");
+        return;
+      }
+
+      handlers[handlerCount++] = handler;
+    }
+
+    void Unsubscribe(const Handler &handler)
+    {
+      for (int i = 0; i < handlerCount; i++)
+      {
+        if (handlers[i] == handler)
+        {
+          handlers[i] = handlers[--handlerCount];
+          handlers[handlerCount] = Handler();
+          return;
+        }
+      }
+    }
+
+    // Takes the tick's events out of the pending buffer, so handlers publish into an empty one.
+    virtual void Swap()
+    {
+      dispatching.swap(pending);
+    }
+
+    virtual void Deliver()
+    {
+      if (dispatching.empty())
+      {
+        return;
+      }
+
+      EventRange<T> range(&dispatching[0], (int)dispatching.size());
+      for (int i = 0; i < handlerCount; i++)
+      {
+        handlers[i](range);
+      }
+
+      // Keeps its memory for the tick after next.
+      dispatching.clear();
+    }
+
+    virtual void Clear()
+    {
+      pending.clear();
+    }
+
+    std::vector<T> pending;
+    std::vector<T> dispatching;
+
+    Handler handlers[kMaxHandlers];
+    int handlerCount;
+  };
+
+  /**
+  * \fn static int EventBus::NextTypeId()
+  * \brief Hands out the channel index of an event type the first time the type is used.
+  */
+  static int NextTypeId();
+
+  template <typename T>
+  static int GetTypeId()
+  {
+    static const int id = NextTypeId();
+    return id;
+  }
+
+  template <typename T>
+  Channel<T>* GetChannel()
+  {
+    int id = GetTypeId<T>();
+    if (id >= (int)_channelsById.size())
+    {
+      _channelsById.resize(id + 1, nullptr);
+    }
+
+    if (_channelsById[id] == nullptr)
+    {
+      _channelsById[id] = new Channel<T>();
+      _channels.push_back(_channelsById[id]);
+    }
+
+    return static_cast<Channel<T> *>(_channelsById[id]);
+  }
+
+  // Indexed by type id, shared by every bus so most buses have holes.
+  std::vector<ChannelBase *> _channelsById;
+
+  // The same channels in the order they were created, which is the dispatch order.
+  std::vector<ChannelBase *> _channels;
+
+  bool _isDispatching;
+};
\ No newline at end of file
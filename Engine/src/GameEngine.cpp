@@ -1,12 +1,29 @@
 #include "GameEngine.h"
+#include "AssetLoader.h"
+#include "AudioManager.h"
 #include <SDL.h>
 #include <SDL_image.h>
 #include "MathUtils.h"
 #include "Graphics.h"
 #include "GraphicsOpenGL.h"
+#include "InputManager.h"
+#include "InputRecorder.h"
+#include "Metrics.h"
+#include "ResourceManager.h"
+#include "ThreadPool.h"
 #include <SDL_opengl.h>
+#include <time.h>
 
-GameEngine::GameEngine()
+GameEngine::GameEngine() :
+_metricsSink(nullptr),
+_frameIndex(0),
+_subsystemFlags(SDL_INIT_VIDEO | SDL_INIT_AUDIO | SDL_INIT_EVENTS),
+_inputRecorder(nullptr),
+_seed((Uint32)time(NULL)),
+_isHeadless(false),
+_isRunning(false),
+_threadPool(nullptr),
+_assetLoader(nullptr)
 {
 
 }
@@ -18,24 +35,60 @@ GameEngine::~GameEngine()
 
 SDL_GLContext gContext;
 
-void GameEngine::Initialize()
+bool GameEngine::Initialize()
 {
-  SDL_Init(SDL_INIT_EVERYTHING);
+  Uint32 subsystems = _subsystemFlags;
+  if (_isHeadless)
+  {
+    // No display or sound card needed, eg. on a build machine. Input still arrives as events.
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+    subsystems = (subsystems & ~SDL_INIT_VIDEO) | SDL_INIT_EVENTS;
+  }
 
-  _window = SDL_CreateWindow("Engine",
-    SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
-    640, 640,
-    SDL_WINDOW_OPENGL | SDL_WINDOW_SHOWN);
-  _graphicsObject = new GraphicsOpenGL();
+  // Only what was asked for. The registry logs which subsystem failed.
+  if (_subsystems.Start(subsystems) == false)
+  {
+    _subsystems.Stop();
+    SDL_Quit();
+    return false;
+  }
+
+  if (_isHeadless)
+  {
+    // The base Graphics draws nothing, it only counts what the game submits.
+    _window = nullptr;
+    _graphicsObject = new Graphics();
+  }
+  else
+  {
+    _window = SDL_CreateWindow("Engine",
+      SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+      640, 640,
+      SDL_WINDOW_OPENGL | SDL_WINDOW_SHOWN);
+    _graphicsObject = new GraphicsOpenGL();
+  }
   _graphicsObject->Initialize(_window);
 
-  IMG_Init(IMG_INIT_JPG | IMG_INIT_PNG | IMG_INIT_TIF | IMG_INIT_WEBP);
+  _threadPool = new ThreadPool();
+  _assetLoader = new AssetLoader(_threadPool);
+
+  // A replay runs with the seed it was recorded with.
+  if (_inputRecorder != nullptr && _inputRecorder->GetMode() == InputRecorder::MODE_REPLAYING)
+  {
+    _seed = _inputRecorder->GetSeed();
+  }
+
+  InputManager::GetInstance()->SetRecorder(_inputRecorder);
+  InputManager::GetInstance()->AssignEvent<GameEngine, &GameEngine::OnQuit>(SDL_QUIT, this);
+  _isRunning = true;
 
   InitializeImpl(_graphicsObject);
 
   /* Get the time at the beginning of our game loop so that we can track the
   * elapsed difference. */
   _engineTimer.Start();
+  return true;
 }
 
 void GameEngine::Shutdown()
@@ -43,11 +96,26 @@ void GameEngine::Shutdown()
   /* Stop the engine timer as we're shutting down. */
   _engineTimer.Stop();
 
+  InputManager::GetInstance()->RemoveEvent<GameEngine, &GameEngine::OnQuit>(SDL_QUIT, this);
+  InputManager::GetInstance()->SetRecorder(nullptr);
+
+  // The audio manager waits for sounds still decoding, so it has to go before the pool.
+  AudioManager::DestroyInstance();
+  ResourceManager::DestroyInstance();
+  delete _assetLoader;
+  _assetLoader = nullptr;
+  delete _threadPool;
+  _threadPool = nullptr;
+
   _graphicsObject->Shutdown();
-  SDL_DestroyWindow(_window);
+  if (_window != nullptr)
+  {
+    SDL_DestroyWindow(_window);
+  }
 
-  /* Quit and clean up all libraries. */
+  /* Quit and clean up all libraries. The image loaders are only there if an image was loaded. */
   IMG_Quit();
+  _subsystems.Stop();
   SDL_Quit();
 }
 
@@ -55,12 +123,40 @@ void GameEngine::Update()
 {
   // Calculating the time difference since our last loop.
   _engineTimer.Update();
+  float dt = _engineTimer.GetDeltaTime();
+
+  if (_inputRecorder != nullptr)
+  {
+    if (_inputRecorder->GetMode() == InputRecorder::MODE_REPLAYING)
+    {
+      // Replay the tick with the delta time it was recorded with.
+      if (_inputRecorder->ReadTick(dt) == false)
+      {
+        _isRunning = false;
+        return;
+      }
+    }
+    else
+    {
+      _inputRecorder->BeginTick(dt);
+    }
+  }
 
-  UpdateImpl(_graphicsObject, _engineTimer.GetDeltaTime());
+  UpdateImpl(_graphicsObject, dt);
+
+  // Start the sounds the game triggered this tick.
+  AudioManager::GetInstance()->Update();
+
+  if (_inputRecorder != nullptr)
+  {
+    _inputRecorder->EndTick();
+  }
 }
 
 void GameEngine::Draw()
 {
+  _graphicsObject->ResetFrameStats();
+
   // Set the draw colour for screen clearing.
   _graphicsObject->SetClearColour(0.25f, 0.25f, 0.25f, 1.0f);
 
@@ -69,6 +165,95 @@ void GameEngine::Draw()
 
   DrawImpl(_graphicsObject, _engineTimer.GetDeltaTime());
 
+  // Stamp input that arrived while drawing before the swap blocks, when the input manager samples.
+  if (_isHeadless == false)
+  {
+    InputManager::GetInstance()->Sample();
+  }
+
   // Present what is in our renderer to our window.
   _graphicsObject->Present();
+
+  ReportFrameStats();
+  _frameIndex++;
+}
+
+void GameEngine::SetMetricsSink(MetricsSink *sink)
+{
+  _metricsSink = sink;
+}
+
+void GameEngine::SetInputRecorder(InputRecorder *recorder)
+{
+  _inputRecorder = recorder;
+}
+
+void GameEngine::SetHeadless(bool headless)
+{
+  _isHeadless = headless;
+}
+
+void GameEngine::SetSubsystems(Uint32 flags)
+{
+  _subsystemFlags = flags;
+}
+
+void GameEngine::SetSeed(Uint32 seed)
+{
+  _seed = seed;
+}
+
+Uint32 GameEngine::GetSeed() const
+{
+  return _seed;
+}
+
+bool GameEngine::IsRunning() const
+{
+  return _isRunning;
+}
+
+ThreadPool* GameEngine::GetThreadPool() const
+{
+  return _threadPool;
+}
+
+AssetLoader* GameEngine::GetAssetLoader() const
+{
+  return _assetLoader;
+}
+
+void GameEngine::OnQuit(const SDL_Event &)
+{
+  _isRunning = false;
+}
+
+void GameEngine::ReportFrameStats()
+{
+  if (_metricsSink == nullptr)
+  {
+    return;
+  }
+
+  const RenderStats &stats = _graphicsObject->GetFrameStats();
+
+  _metricsSink->BeginFrame(_frameIndex);
+  _metricsSink->Record("render.drawCalls", stats.drawCalls);
+  _metricsSink->Record("render.triangles", stats.triangles);
+  _metricsSink->Record("render.verticesUploaded", stats.verticesUploaded);
+  _metricsSink->Record("render.bytesStreamed", stats.bytesStreamed);
+  _metricsSink->Record("render.stateChanges", stats.stateChanges);
+  _metricsSink->Record("render.textureBinds", stats.textureBinds);
+  _metricsSink->Record("frame.deltaTime", _engineTimer.GetDeltaTime());
+
+  // How long startup took goes with the first frame.
+  if (_frameIndex == 0)
+  {
+    _subsystems.ReportInitTimes(_metricsSink);
+  }
+
+  ResourceManager *resources = ResourceManager::GetInstance();
+  _metricsSink->Record("resources.sounds.bytes", (double)resources->GetSounds().GetMemoryUsed());
+  _metricsSink->Record("resources.images.bytes", (double)resources->GetImages().GetMemoryUsed());
+  _metricsSink->EndFrame();
 }
\ No newline at end of file
@@ -8,7 +8,9 @@
  */
 
 #include "MathUtils.h"
+#include "SubsystemRegistry.h"
 #include "Timer.h"
+#include <SDL_stdinc.h>
 #include <vector>
 
 // Forward declaring our renderer and window.
@@ -18,6 +20,11 @@ struct SDL_Renderer;
 struct SDL_Window;
 class GameObject;
 class Graphics;
+class MetricsSink;
+class InputRecorder;
+class ThreadPool;
+class AssetLoader;
+union SDL_Event;
 
 class GameEngine
 {
@@ -28,12 +35,63 @@ public:
    */
   static GameEngine* CreateInstance();
 
-  void Initialize();
+  /**
+   * Starts SDL, creates the window and graphics and initializes the game.
+   * @return false, with nothing left running, if an SDL subsystem the engine needs could not be started.
+   */
+  bool Initialize();
   void Shutdown();
 
   void Update();
   void Draw();
 
+  /**
+   * Sets where the per-frame render statistics are reported, NULL to stop reporting.
+   * The engine does not take ownership of the sink.
+   */
+  void SetMetricsSink(MetricsSink *sink);
+
+  /**
+   * Sets the recorder the engine's ticks are logged to, or replayed from. Call before Initialize.
+   * When replaying, the seed and every tick's delta time come from the log and the engine stops
+   * running once the log runs out. The engine does not take ownership of the recorder.
+   */
+  void SetInputRecorder(InputRecorder *recorder);
+
+  /**
+   * Runs without a window or a GL context, on SDL's dummy video and audio drivers. The game still draws every
+   * frame into a Graphics that draws nothing, so the render metrics count what would have been drawn.
+   * Call before Initialize.
+   */
+  void SetHeadless(bool headless);
+
+  /**
+   * Sets the SDL subsystems started by Initialize, as SDL_INIT_* flags. Defaults to video, audio and events;
+   * headless runs drop video. Call before Initialize.
+   */
+  void SetSubsystems(Uint32 flags);
+
+  /**
+   * Sets the seed the game generates its random numbers from. Defaults to the current time.
+   */
+  void SetSeed(Uint32 seed);
+  Uint32 GetSeed() const;
+
+  /**
+   * @return false once the window was closed or a replay ran out of ticks.
+   */
+  bool IsRunning() const;
+
+  /**
+   * @return The worker threads shared by the engine and the game, valid between Initialize and Shutdown.
+   */
+  ThreadPool* GetThreadPool() const;
+
+  /**
+   * @return The loader that decodes assets on the thread pool, valid between Initialize and Shutdown.
+   */
+  AssetLoader* GetAssetLoader() const;
+
   ~GameEngine();
 
 protected:
@@ -43,6 +101,10 @@ protected:
   virtual void UpdateImpl(Graphics * graphics, float dt) = 0;
   virtual void DrawImpl(Graphics *graphics, float dt) = 0;
 
+  void ReportFrameStats();
+
+  void OnQuit(const SDL_Event &evt);
+
   static GameEngine *_instance;
 
   SDL_Window *_window;
@@ -52,4 +114,18 @@ protected:
   std::vector<GameObject *> _objects;
 
   float _oldTime, _currentTime, _deltaTime;
+
+  MetricsSink *_metricsSink;
+  unsigned int _frameIndex;
+
+  SubsystemRegistry _subsystems;
+  Uint32 _subsystemFlags;
+
+  InputRecorder *_inputRecorder;
+  Uint32 _seed;
+  bool _isHeadless;
+  bool _isRunning;
+
+  ThreadPool *_threadPool;
+  AssetLoader *_assetLoader;
 };
\ No newline at end of file
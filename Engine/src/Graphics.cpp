@@ -1,5 +1,21 @@
 #include "Graphics.h"
 
+RenderStats::RenderStats() :
+drawCalls(0),
+triangles(0),
+verticesUploaded(0),
+bytesStreamed(0),
+stateChanges(0),
+textureBinds(0)
+{ }
+
+Graphics::Graphics() :
+_rendererObject(nullptr),
+_window(nullptr)
+{ }
+
+Graphics::~Graphics() { }
+
 void Graphics::Initialize(SDL_Window *window)
 {
 
@@ -13,4 +29,57 @@ void Graphics::Shutdown()
 void Graphics::SetClearColour(float r, float g, float b, float a) { }
 void Graphics::ClearScreen() {}
 
-void Graphics::Present() { }
\ No newline at end of file
+void Graphics::Present() { }
+
+void Graphics::PushMatrix() { }
+void Graphics::PopMatrix() { }
+void Graphics::Translate(float x, float y, float z) { }
+void Graphics::Rotate(float degrees, float x, float y, float z) { }
+void Graphics::Scale(float x, float y, float z) { }
+
+void Graphics::DrawTriangles(const Vector3 *positions, const Vector4 *colours, unsigned int vertexCount,
+  const unsigned int *indices, unsigned int indexCount)
+{
+  if (indexCount == 0)
+  {
+    return;
+  }
+
+  DrawTrianglesImpl(positions, colours, vertexCount, indices, indexCount);
+  RecordDrawCall(indexCount / 3, vertexCount,
+    vertexCount * (sizeof(Vector3) + sizeof(Vector4)) + indexCount * sizeof(unsigned int));
+}
+
+void Graphics::DrawTrianglesImpl(const Vector3 *positions, const Vector4 *colours, unsigned int vertexCount,
+  const unsigned int *indices, unsigned int indexCount)
+{
+
+}
+
+void Graphics::ResetFrameStats()
+{
+  _frameStats = RenderStats();
+}
+
+const RenderStats& Graphics::GetFrameStats() const
+{
+  return _frameStats;
+}
+
+void Graphics::RecordDrawCall(unsigned int triangles, unsigned int vertices, unsigned int bytes)
+{
+  _frameStats.drawCalls++;
+  _frameStats.triangles += triangles;
+  _frameStats.verticesUploaded += vertices;
+  _frameStats.bytesStreamed += bytes;
+}
+
+void Graphics::RecordStateChange(unsigned int count)
+{
+  _frameStats.stateChanges += count;
+}
+
+void Graphics::RecordTextureBind()
+{
+  _frameStats.textureBinds++;
+}
\ No newline at end of file
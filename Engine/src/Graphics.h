@@ -4,9 +4,26 @@
 
 struct SDL_Window;
 
+// Per-frame counters of the work submitted to a Graphics object.
+// They live in the base class so every backend, including the do-nothing base Graphics, reports them.
+struct RenderStats
+{
+  unsigned int drawCalls;
+  unsigned int triangles;
+  unsigned int verticesUploaded;
+  unsigned int bytesStreamed;
+  unsigned int stateChanges;
+  unsigned int textureBinds;
+
+  RenderStats();
+};
+
 class Graphics
 {
 public:
+  Graphics();
+  virtual ~Graphics();
+
   virtual void Initialize(SDL_Window *window);
   virtual void Shutdown();
 
@@ -15,9 +32,33 @@ public:
 
   virtual void Present();
 
+  // Fixed function transforms, applied to everything drawn until the matching PopMatrix.
+  virtual void PushMatrix();
+  virtual void PopMatrix();
+  virtual void Translate(float x, float y, float z);
+  virtual void Rotate(float degrees, float x, float y, float z);
+  virtual void Scale(float x, float y, float z);
+
+  // Draws indexed triangles from client-side arrays, one colour per vertex. The arrays are streamed to the
+  // backend on every call, which is what gets counted, so the counts are the same whether or not anything is drawn.
+  void DrawTriangles(const Vector3 *positions, const Vector4 *colours, unsigned int vertexCount,
+    const unsigned int *indices, unsigned int indexCount);
+
+  void ResetFrameStats();
+  const RenderStats& GetFrameStats() const;
+
+  void RecordDrawCall(unsigned int triangles, unsigned int vertices, unsigned int bytes);
+  void RecordStateChange(unsigned int count = 1);
+  void RecordTextureBind();
+
 protected:
+  virtual void DrawTrianglesImpl(const Vector3 *positions, const Vector4 *colours, unsigned int vertexCount,
+    const unsigned int *indices, unsigned int indexCount);
+
   void *_rendererObject;
   Vector4 _clearColour;
 
   SDL_Window *_window;
+
+  RenderStats _frameStats;
 };
\ No newline at end of file
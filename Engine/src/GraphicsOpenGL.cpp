@@ -31,6 +31,14 @@ void GraphicsOpenGL::Initialize(SDL_Window *window)
 
   glEnable(GL_DEPTH_TEST);
 
+  // Every mesh in the game is wound clockwise.
+  glFrontFace(GL_CW);
+  glCullFace(GL_BACK);
+
+  // Every draw goes through DrawTriangles with positions and colours, so the arrays stay enabled.
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glEnableClientState(GL_COLOR_ARRAY);
+
   glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
   glClearDepth(1.0f);
 
@@ -59,4 +67,37 @@ void GraphicsOpenGL::ClearScreen()
 void GraphicsOpenGL::Present()
 { 
   SDL_GL_SwapWindow(_window);
+}
+
+void GraphicsOpenGL::PushMatrix()
+{
+  glPushMatrix();
+}
+
+void GraphicsOpenGL::PopMatrix()
+{
+  glPopMatrix();
+}
+
+void GraphicsOpenGL::Translate(float x, float y, float z)
+{
+  glTranslatef(x, y, z);
+}
+
+void GraphicsOpenGL::Rotate(float degrees, float x, float y, float z)
+{
+  glRotatef(degrees, x, y, z);
+}
+
+void GraphicsOpenGL::Scale(float x, float y, float z)
+{
+  glScalef(x, y, z);
+}
+
+void GraphicsOpenGL::DrawTrianglesImpl(const Vector3 *positions, const Vector4 *colours, unsigned int vertexCount,
+  const unsigned int *indices, unsigned int indexCount)
+{
+  glVertexPointer(3, GL_FLOAT, 0, positions);
+  glColorPointer(4, GL_FLOAT, 0, colours);
+  glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, indices);
 }
\ No newline at end of file
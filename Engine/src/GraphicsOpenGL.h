@@ -16,5 +16,13 @@ public:
 
   void Present();
 
+  void PushMatrix();
+  void PopMatrix();
+  void Translate(float x, float y, float z);
+  void Rotate(float degrees, float x, float y, float z);
+  void Scale(float x, float y, float z);
+
 protected:
+  void DrawTrianglesImpl(const Vector3 *positions, const Vector4 *colours, unsigned int vertexCount,
+    const unsigned int *indices, unsigned int indexCount);
 };
\ No newline at end of file
@@ -0,0 +1,207 @@
+/**
+ * \class Grid
+ * \brief A two dimensional array of cells stored row-major in one contiguous allocation.
+ *
+ * Resizing keeps the allocation whenever the new size fits in it, so a grid that grows and shrinks between levels
+ * stops allocating once it has reached its largest size. Grid<bool> packs its cells into 32 bit words.
+ */
+
+#pragma once
+#include <SDL_stdinc.h>
+#include <vector>
+
+template <typename T>
+class Grid
+{
+public:
+  /**
+  * \fn Grid::Grid()
+  * \brief Creates an empty grid.
+  */
+  Grid() : _rows(0), _columns(0) { }
+
+  /**
+  * \fn Grid::Grid(int rows, int columns, const T &value)
+  * \brief Creates a grid with every cell set to the given value.
+  */
+  Grid(int rows, int columns, const T &value = T()) : _rows(0), _columns(0)
+  {
+    Resize(rows, columns, value);
+  }
+
+  /**
+  * \fn void Grid::Resize(int rows, int columns, const T &value)
+  * \brief Changes the size of the grid and sets every cell to the given value. Only allocates when the grid
+  * has never been this big.
+  */
+  void Resize(int rows, int columns, const T &value = T())
+  {
+    _rows = rows;
+    _columns = columns;
+    _cells.assign(rows * columns, value);
+  }
+
+  /**
+  * \fn void Grid::Reserve(int count)
+  * \brief Allocates room for the given number of cells up front, eg. for the largest level.
+  */
+  void Reserve(int count)
+  {
+    _cells.reserve(count);
+  }
+
+  /**
+  * \fn void Grid::Fill(const T &value)
+  * \brief Sets every cell to the given value.
+  */
+  void Fill(const T &value)
+  {
+    _cells.assign(_cells.size(), value);
+  }
+
+  int GetRows() const { return _rows; }
+  int GetColumns() const { return _columns; }
+  int GetCount() const { return (int)_cells.size(); }
+  int GetCapacity() const { return (int)_cells.capacity(); }
+
+  /**
+  * \fn bool Grid::Contains(int row, int column) const
+  * \brief Gets whether or not a cell is inside the grid.
+  */
+  bool Contains(int row, int column) const
+  {
+    return row >= 0 && row < _rows && column >= 0 && column < _columns;
+  }
+
+  /**
+  * \fn T& Grid::operator()(int row, int column)
+  * \brief Gets a cell. The cell has to be inside the grid.
+  */
+  T& operator()(int row, int column)
+  {
+    return _cells[row * _columns + column];
+  }
+
+  const T& operator()(int row, int column) const
+  {
+    return _cells[row * _columns + column];
+  }
+
+  /**
+  * \fn T* Grid::GetRow(int row)
+  * \brief Gets the first cell of a row, the rest of the row follows it.
+  */
+  T* GetRow(int row)
+  {
+    return &_cells[row * _columns];
+  }
+
+  const T* GetRow(int row) const
+  {
+    return &_cells[row * _columns];
+  }
+
+protected:
+  int _rows, _columns;
+  std::vector<T> _cells;
+};
+
+template <>
+class Grid<bool>
+{
+public:
+  Grid() : _rows(0), _columns(0), _count(0) { }
+
+  Grid(int rows, int columns, bool value = false) : _rows(0), _columns(0), _count(0)
+  {
+    Resize(rows, columns, value);
+  }
+
+  void Resize(int rows, int columns, bool value = false)
+  {
+    _rows = rows;
+    _columns = columns;
+    _count = rows * columns;
+    _words.resize((_count + 31) / 32);
+    Fill(value);
+  }
+
+  void Reserve(int count)
+  {
+    _words.reserve((count + 31) / 32);
+  }
+
+  void Fill(bool value)
+  {
+    _words.assign(_words.size(), value ? 0xFFFFFFFFu : 0u);
+    ClearPadding();
+  }
+
+  int GetRows() const { return _rows; }
+  int GetColumns() const { return _columns; }
+  int GetCount() const { return _count; }
+  int GetCapacity() const { return (int)_words.capacity() * 32; }
+
+  bool Contains(int row, int column) const
+  {
+    return row >= 0 && row < _rows && column >= 0 && column < _columns;
+  }
+
+  bool operator()(int row, int column) const
+  {
+    int index = row * _columns + column;
+    return (_words[index >> 5] & (1u << (index & 31))) != 0;
+  }
+
+  void Set(int row, int column, bool value)
+  {
+    int index = row * _columns + column;
+    if (value)
+    {
+      _words[index >> 5] |= 1u << (index & 31);
+    }
+    else
+    {
+      _words[index >> 5] &= ~(1u << (index & 31));
+    }
+  }
+
+  /**
+  * \fn int Grid<bool>::CountSet() const
+  * \brief Gets the number of cells that are set, a word at a time.
+  */
+  int CountSet() const
+  {
+    int set = 0;
+    for (auto itr = _words.begin(); itr != _words.end(); itr++)
+    {
+      Uint32 bits = *itr;
+      bits = bits - ((bits >> 1) & 0x55555555u);
+      bits = (bits & 0x33333333u) + ((bits >> 2) & 0x33333333u);
+      set += (int)((((bits + (bits >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+    }
+    return set;
+  }
+
+  /**
+  * \fn bool Grid<bool>::IsAllSet() const
+  * \brief Gets whether or not every cell is set.
+  */
+  bool IsAllSet() const
+  {
+    return CountSet() == _count;
+  }
+
+protected:
+  // Keeps the bits past the last cell clear so whole words can be counted.
+  void ClearPadding()
+  {
+    if ((_count & 31) != 0)
+    {
+      _words.back() &= (1u << (_count & 31)) - 1;
+    }
+  }
+
+  int _rows, _columns, _count;
+  std::vector<Uint32> _words;
+};
\ No newline at end of file
@@ -0,0 +1,208 @@
+#include "GridOccupancy.h"
+
+GridOccupancy::GridOccupancy() :
+_rows(0),
+_columns(0),
+_firstRow(0),
+_firstColumn(0)
+{
+}
+
+void GridOccupancy::Resize(int rows, int columns, int maxEntities, int firstRow, int firstColumn)
+{
+  _rows = rows;
+  _columns = columns;
+  _firstRow = firstRow;
+  _firstColumn = firstColumn;
+
+  Cell emptyCell = { kNoEntity, -1, false };
+  _cells.assign(rows * columns, emptyCell);
+
+  Entity offGrid = { -1, kNoEntity, kNoEntity };
+  _entities.assign(maxEntities, offGrid);
+
+  _freeCells.clear();
+  for (int cell = 0; cell < rows * columns; cell++)
+  {
+    MarkFree(cell);
+  }
+}
+
+bool GridOccupancy::Insert(EntityId entity, int row, int column)
+{
+  return Move(entity, row, column);
+}
+
+bool GridOccupancy::Move(EntityId entity, int row, int column)
+{
+  Unlink(entity);
+  if (Contains(row, column) == false)
+  {
+    return false;
+  }
+
+  int cell = GetCell(row, column);
+  Entity &moved = _entities[entity];
+  moved.cell = cell;
+  moved.previous = kNoEntity;
+  moved.next = _cells[cell].first;
+  if (moved.next != kNoEntity)
+  {
+    _entities[moved.next].previous = entity;
+  }
+  else
+  {
+    MarkTaken(cell);
+  }
+  _cells[cell].first = entity;
+  return true;
+}
+
+void GridOccupancy::Remove(EntityId entity)
+{
+  Unlink(entity);
+}
+
+void GridOccupancy::SetBlocked(int row, int column, bool blocked)
+{
+  if (Contains(row, column) == false)
+  {
+    return;
+  }
+
+  int cell = GetCell(row, column);
+  _cells[cell].isBlocked = blocked;
+  if (blocked)
+  {
+    MarkTaken(cell);
+  }
+  else if (_cells[cell].first == kNoEntity)
+  {
+    MarkFree(cell);
+  }
+}
+
+bool GridOccupancy::Contains(int row, int column) const
+{
+  return row >= _firstRow && row < _firstRow + _rows && column >= _firstColumn && column < _firstColumn + _columns;
+}
+
+bool GridOccupancy::IsOnGrid(EntityId entity) const
+{
+  return _entities[entity].cell >= 0;
+}
+
+bool GridOccupancy::IsOccupied(int row, int column) const
+{
+  return GetFirst(row, column) != kNoEntity;
+}
+
+GridOccupancy::EntityId GridOccupancy::GetFirst(int row, int column) const
+{
+  return Contains(row, column) ? _cells[GetCell(row, column)].first : kNoEntity;
+}
+
+GridOccupancy::EntityId GridOccupancy::GetNext(EntityId entity) const
+{
+  return _entities[entity].next;
+}
+
+int GridOccupancy::GetFreeCellCount() const
+{
+  return (int)_freeCells.size();
+}
+
+void GridOccupancy::GetFreeCell(int index, int &row, int &column) const
+{
+  int cell = _freeCells[index];
+  row = _firstRow + cell / _columns;
+  column = _firstColumn + cell % _columns;
+}
+
+void GridOccupancy::Save(Snapshot &snapshot) const
+{
+  Sint32 window[4] = { _rows, _columns, _firstRow, _firstColumn };
+  snapshot.Write(window);
+  snapshot.WriteVector(_cells);
+  snapshot.WriteVector(_entities);
+  snapshot.WriteVector(_freeCells);
+}
+
+bool GridOccupancy::Restore(Snapshot &snapshot)
+{
+  Sint32 window[4];
+  if (snapshot.Read(window) == false)
+  {
+    return false;
+  }
+
+  _rows = window[0];
+  _columns = window[1];
+  _firstRow = window[2];
+  _firstColumn = window[3];
+  return snapshot.ReadVector(_cells) && snapshot.ReadVector(_entities) && snapshot.ReadVector(_freeCells);
+}
+
+int GridOccupancy::GetCell(int row, int column) const
+{
+  return (row - _firstRow) * _columns + column - _firstColumn;
+}
+
+void GridOccupancy::Unlink(EntityId entity)
+{
+  Entity &unlinked = _entities[entity];
+  if (unlinked.cell < 0)
+  {
+    return;
+  }
+
+  if (unlinked.previous != kNoEntity)
+  {
+    _entities[unlinked.previous].next = unlinked.next;
+  }
+  else
+  {
+    _cells[unlinked.cell].first = unlinked.next;
+  }
+
+  if (unlinked.next != kNoEntity)
+  {
+    _entities[unlinked.next].previous = unlinked.previous;
+  }
+
+  if (_cells[unlinked.cell].first == kNoEntity)
+  {
+    MarkFree(unlinked.cell);
+  }
+
+  unlinked.cell = -1;
+  unlinked.previous = kNoEntity;
+  unlinked.next = kNoEntity;
+}
+
+void GridOccupancy::MarkFree(int cell)
+{
+  if (_cells[cell].freeSlot >= 0 || _cells[cell].isBlocked)
+  {
+    return;
+  }
+
+  _cells[cell].freeSlot = (int)_freeCells.size();
+  _freeCells.push_back(cell);
+}
+
+void GridOccupancy::MarkTaken(int cell)
+{
+  int slot = _cells[cell].freeSlot;
+  if (slot < 0)
+  {
+    return;
+  }
+
+  // Swap the last free cell into the hole.
+  int last = _freeCells.back();
+  _freeCells[slot] = last;
+  _cells[last].freeSlot = slot;
+  _freeCells.pop_back();
+  _cells[cell].freeSlot = -1;
+}
\ No newline at end of file
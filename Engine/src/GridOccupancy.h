@@ -0,0 +1,128 @@
+/**
+ * \class GridOccupancy
+ * \brief A spatial hash from grid cells to the entities standing on them, with a list of the cells that are free.
+ *
+ * Entities are small integer ids (eg. an index into the caller's entity array). Each cell holds an intrusive,
+ * doubly linked list of its entities, so inserting, moving, removing and looking up a cell are all constant time.
+ * Cells that are neither occupied nor blocked are kept in a packed list so a random free cell can be picked in
+ * constant time too, eg. for spawning. The grid can start at any row and column, so on a world too big to cover it
+ * can cover just the window around the player.
+ */
+
+#pragma once
+#include "Snapshot.h"
+#include <vector>
+
+class GridOccupancy
+{
+public:
+  typedef int EntityId;
+  static const EntityId kNoEntity = -1;
+
+  /**
+  * \fn GridOccupancy::GridOccupancy()
+  * \brief Creates an empty occupancy grid.
+  */
+  GridOccupancy();
+
+  /**
+  * \fn void GridOccupancy::Resize(int rows, int columns, int maxEntities, int firstRow, int firstColumn)
+  * \brief Empties the grid and changes its size. Every cell becomes free and unblocked. Reuses the grid's memory
+  * when it fits.
+  * \param maxEntities Ids go from 0 to maxEntities - 1.
+  * \param firstRow, firstColumn The cell the grid starts at. Every other function takes cells in the same
+  * coordinates, so only this call has to know where the window is.
+  */
+  void Resize(int rows, int columns, int maxEntities, int firstRow = 0, int firstColumn = 0);
+
+  /**
+  * \fn bool GridOccupancy::Insert(EntityId entity, int row, int column)
+  * \brief Puts an entity on a cell. An entity that is already on the grid is moved instead.
+  * \return false if the cell is outside the grid, in which case the entity is left off the grid.
+  */
+  bool Insert(EntityId entity, int row, int column);
+
+  /**
+  * \fn bool GridOccupancy::Move(EntityId entity, int row, int column)
+  * \brief Moves an entity to another cell. Moving it outside the grid removes it.
+  * \return false if the entity ended up off the grid.
+  */
+  bool Move(EntityId entity, int row, int column);
+
+  /**
+  * \fn void GridOccupancy::Remove(EntityId entity)
+  * \brief Takes an entity off the grid. Does nothing if it isn't on it.
+  */
+  void Remove(EntityId entity);
+
+  /**
+  * \fn void GridOccupancy::SetBlocked(int row, int column, bool blocked)
+  * \brief Keeps a cell out of the free list even while it is empty, eg. the player's starting cell. Cells outside
+  * the grid are ignored.
+  */
+  void SetBlocked(int row, int column, bool blocked);
+
+  bool Contains(int row, int column) const;
+  bool IsOnGrid(EntityId entity) const;
+  bool IsOccupied(int row, int column) const;
+
+  /**
+  * \fn EntityId GridOccupancy::GetFirst(int row, int column) const
+  * \brief Gets the first entity on a cell; GetNext walks the rest.
+  * \return kNoEntity if the cell is empty or outside the grid.
+  */
+  EntityId GetFirst(int row, int column) const;
+  EntityId GetNext(EntityId entity) const;
+
+  /**
+  * \fn int GridOccupancy::GetFreeCellCount() const
+  * \brief Gets the number of cells that are neither occupied nor blocked.
+  */
+  int GetFreeCellCount() const;
+
+  /**
+  * \fn void GridOccupancy::GetFreeCell(int index, int &row, int &column) const
+  * \brief Gets one of the free cells. The order changes as cells are taken and freed.
+  * \param index Below GetFreeCellCount, eg. a random number.
+  */
+  void GetFreeCell(int index, int &row, int &column) const;
+
+  /**
+  * \fn void GridOccupancy::Save(Snapshot &snapshot) const
+  * \brief Appends the cells, entity links and free list to a snapshot, each as a single copy.
+  */
+  void Save(Snapshot &snapshot) const;
+
+  /**
+  * \fn bool GridOccupancy::Restore(Snapshot &snapshot)
+  * \brief Reads back what Save wrote, including the order GetFreeCell hands out cells in.
+  * \return false if the snapshot ran out.
+  */
+  bool Restore(Snapshot &snapshot);
+
+protected:
+  struct Cell
+  {
+    EntityId first;
+    int freeSlot; // position in _freeCells, -1 when not free
+    bool isBlocked;
+  };
+
+  struct Entity
+  {
+    int cell; // -1 when off the grid
+    EntityId previous;
+    EntityId next;
+  };
+
+  int GetCell(int row, int column) const;
+  void Unlink(EntityId entity);
+  void MarkFree(int cell);
+  void MarkTaken(int cell);
+
+  int _rows, _columns;
+  int _firstRow, _firstColumn;
+  std::vector<Cell> _cells;
+  std::vector<Entity> _entities;
+  std::vector<int> _freeCells;
+};
\ No newline at end of file
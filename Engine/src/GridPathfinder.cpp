@@ -0,0 +1,338 @@
+#include "GridPathfinder.h"
+#include <algorithm>
+#include <stdlib.h>
+
+// Row and column offsets of the four neighbours. Opposite directions differ in the lowest bit only.
+static const int kSteps[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+static const Uint8 kNoDirection = 4;
+
+FlowField::FlowField() :
+_rows(0),
+_columns(0),
+_firstRow(0),
+_firstColumn(0),
+_targetRow(-1),
+_targetColumn(-1),
+_mapVersion(0)
+{
+}
+
+bool FlowField::GetStep(int row, int column, int &rowStep, int &columnStep) const
+{
+  rowStep = 0;
+  columnStep = 0;
+
+  row -= _firstRow;
+  column -= _firstColumn;
+  if (row < 0 || row >= _rows || column < 0 || column >= _columns)
+  {
+    return false;
+  }
+
+  Uint8 direction = _directions[row * _columns + column];
+  if (direction == kNoDirection)
+  {
+    return false;
+  }
+
+  rowStep = kSteps[direction][0];
+  columnStep = kSteps[direction][1];
+  return true;
+}
+
+int FlowField::GetDistance(int row, int column) const
+{
+  row -= _firstRow;
+  column -= _firstColumn;
+  if (row < 0 || row >= _rows || column < 0 || column >= _columns)
+  {
+    return -1;
+  }
+
+  return _distances[row * _columns + column];
+}
+
+int FlowField::GetTargetRow() const
+{
+  return _targetRow;
+}
+
+int FlowField::GetTargetColumn() const
+{
+  return _targetColumn;
+}
+
+GridPathfinder::GridPathfinder() :
+_rows(0),
+_columns(0),
+_firstRow(0),
+_firstColumn(0),
+_mapVersion(1),
+_generation(0),
+_visitedCount(0)
+{
+}
+
+void GridPathfinder::Resize(int rows, int columns, int firstRow, int firstColumn)
+{
+  _rows = rows;
+  _columns = columns;
+  _firstRow = firstRow;
+  _firstColumn = firstColumn;
+  _mapVersion++;
+
+  int cells = rows * columns;
+  _blocked.assign(cells, 0);
+  _generations.assign(cells, 0);
+  _costs.resize(cells);
+  _parents.resize(cells);
+  _generation = 0;
+
+  // Every cell goes through the queue at most once, and the heap rarely holds more than a few per cell.
+  _queue.reserve(cells);
+  _open.reserve(cells);
+}
+
+void GridPathfinder::SetBlocked(int row, int column, bool blocked)
+{
+  if (Contains(row, column) == false)
+  {
+    return;
+  }
+
+  Uint8 &cell = _blocked[GetCell(row, column)];
+  if (cell != (Uint8)blocked)
+  {
+    cell = (Uint8)blocked;
+    _mapVersion++;
+  }
+}
+
+bool GridPathfinder::IsBlocked(int row, int column) const
+{
+  return Contains(row, column) == false || _blocked[GetCell(row, column)] != 0;
+}
+
+bool GridPathfinder::Contains(int row, int column) const
+{
+  return row >= _firstRow && row < _firstRow + _rows && column >= _firstColumn && column < _firstColumn + _columns;
+}
+
+bool GridPathfinder::FindPath(int startRow, int startColumn, int goalRow, int goalColumn, std::vector<GridCell> &path)
+{
+  path.clear();
+  _visitedCount = 0;
+  if (IsBlocked(startRow, startColumn) || IsBlocked(goalRow, goalColumn))
+  {
+    return false;
+  }
+
+  int start = GetCell(startRow, startColumn);
+  int goal = GetCell(goalRow, goalColumn);
+  if (start == goal)
+  {
+    return true;
+  }
+
+  // A new generation forgets the previous search without touching every cell.
+  if (++_generation == 0)
+  {
+    std::fill(_generations.begin(), _generations.end(), 0);
+    _generation = 1;
+  }
+
+  int goalLocalRow = goalRow - _firstRow;
+  int goalLocalColumn = goalColumn - _firstColumn;
+
+  _open.clear();
+  _generations[start] = _generation;
+  _costs[start] = 0;
+  _parents[start] = -1;
+  OpenNode first = { abs(startRow - goalRow) + abs(startColumn - goalColumn), 0, start };
+  PushOpen(first);
+
+  while (_open.empty() == false)
+  {
+    OpenNode node = PopOpen();
+
+    // A cheaper way to this cell was found after the node was pushed.
+    if (node.cost != _costs[node.cell])
+    {
+      continue;
+    }
+
+    _visitedCount++;
+    if (node.cell == goal)
+    {
+      for (int cell = goal; cell != start; cell = _parents[cell])
+      {
+        GridCell step = { _firstRow + cell / _columns, _firstColumn + cell % _columns };
+        path.push_back(step);
+      }
+      std::reverse(path.begin(), path.end());
+      return true;
+    }
+
+    int row = node.cell / _columns;
+    int column = node.cell % _columns;
+    for (int direction = 0; direction < 4; direction++)
+    {
+      int nextRow = row + kSteps[direction][0];
+      int nextColumn = column + kSteps[direction][1];
+      if (nextRow < 0 || nextRow >= _rows || nextColumn < 0 || nextColumn >= _columns)
+      {
+        continue;
+      }
+
+      int next = nextRow * _columns + nextColumn;
+      int cost = node.cost + 1;
+      if (_blocked[next] != 0 || (_generations[next] == _generation && _costs[next] <= cost))
+      {
+        continue;
+      }
+
+      _generations[next] = _generation;
+      _costs[next] = cost;
+      _parents[next] = node.cell;
+
+      // Manhattan distance never overestimates on a four-neighbour grid, so the first path found is a shortest one.
+      OpenNode open = { cost + abs(nextRow - goalLocalRow) + abs(nextColumn - goalLocalColumn), cost, next };
+      PushOpen(open);
+    }
+  }
+
+  return false;
+}
+
+bool GridPathfinder::UpdateFlowField(FlowField &field, int targetRow, int targetColumn)
+{
+  if (field._mapVersion == _mapVersion && field._targetRow == targetRow && field._targetColumn == targetColumn)
+  {
+    return false;
+  }
+
+  field._rows = _rows;
+  field._columns = _columns;
+  field._firstRow = _firstRow;
+  field._firstColumn = _firstColumn;
+  field._targetRow = targetRow;
+  field._targetColumn = targetColumn;
+  field._mapVersion = _mapVersion;
+
+  int cells = _rows * _columns;
+  field._distances.assign(cells, -1);
+  field._directions.assign(cells, kNoDirection);
+
+  _visitedCount = 0;
+  if (IsBlocked(targetRow, targetColumn))
+  {
+    return true;
+  }
+
+  // Breadth first out of the target, each cell points back at the neighbour it was reached from.
+  int target = GetCell(targetRow, targetColumn);
+  field._distances[target] = 0;
+  _queue.clear();
+  _queue.push_back(target);
+
+  for (size_t head = 0; head < _queue.size(); head++)
+  {
+    int cell = _queue[head];
+    int row = cell / _columns;
+    int column = cell % _columns;
+    int distance = field._distances[cell] + 1;
+
+    for (int direction = 0; direction < 4; direction++)
+    {
+      int nextRow = row + kSteps[direction][0];
+      int nextColumn = column + kSteps[direction][1];
+      if (nextRow < 0 || nextRow >= _rows || nextColumn < 0 || nextColumn >= _columns)
+      {
+        continue;
+      }
+
+      int next = nextRow * _columns + nextColumn;
+      if (_blocked[next] != 0 || field._distances[next] != -1)
+      {
+        continue;
+      }
+
+      field._distances[next] = distance;
+      field._directions[next] = (Uint8)(direction ^ 1);
+      _queue.push_back(next);
+    }
+  }
+
+  _visitedCount = (int)_queue.size();
+  return true;
+}
+
+int GridPathfinder::GetVisitedCount() const
+{
+  return _visitedCount;
+}
+
+int GridPathfinder::GetCell(int row, int column) const
+{
+  return (row - _firstRow) * _columns + column - _firstColumn;
+}
+
+void GridPathfinder::PushOpen(const OpenNode &node)
+{
+  // Sift up.
+  int index = (int)_open.size();
+  _open.push_back(node);
+  while (index > 0)
+  {
+    int parent = (index - 1) / 2;
+    if (IsBefore(node, _open[parent]) == false)
+    {
+      break;
+    }
+
+    _open[index] = _open[parent];
+    index = parent;
+  }
+  _open[index] = node;
+}
+
+GridPathfinder::OpenNode GridPathfinder::PopOpen()
+{
+  OpenNode top = _open[0];
+  OpenNode last = _open.back();
+  _open.pop_back();
+
+  // Sift the last node down from the root.
+  int count = (int)_open.size();
+  int index = 0;
+  while (count > 0)
+  {
+    int child = index * 2 + 1;
+    if (child >= count)
+    {
+      break;
+    }
+    if (child + 1 < count && IsBefore(_open[child + 1], _open[child]))
+    {
+      child++;
+    }
+    if (IsBefore(_open[child], last) == false)
+    {
+      break;
+    }
+
+    _open[index] = _open[child];
+    index = child;
+  }
+  if (count > 0)
+  {
+    _open[index] = last;
+  }
+
+  return top;
+}
+
+bool GridPathfinder::IsBefore(const OpenNode &a, const OpenNode &b)
+{
+  return a.estimate < b.estimate || (a.estimate == b.estimate && a.cost > b.cost);
+}
@@ -0,0 +1,152 @@
+/**
+ * \class GridPathfinder
+ * \brief Shortest paths over a grid of walkable and blocked cells, stepping to the four neighbours of a cell.
+ *
+ * FindPath answers single queries with A*. Its open list is a binary heap kept in a vector, and per-cell costs are
+ * tagged with a search generation instead of being cleared, so a query allocates nothing once the pathfinder is
+ * warm. When many entities chase the same target, a FlowField is cheaper: one breadth-first pass gives every cell
+ * its step toward the target, and UpdateFlowField only redoes that pass when the target changes cell or the map
+ * changes. Like GridOccupancy the grid can start at any row and column.
+ */
+
+#pragma once
+#include <SDL_stdinc.h>
+#include <vector>
+
+struct GridCell
+{
+  int row, column;
+};
+
+class GridPathfinder;
+
+/**
+ * \class FlowField
+ * \brief The step toward a target from every cell of a GridPathfinder's grid, filled in by UpdateFlowField.
+ */
+class FlowField
+{
+public:
+  FlowField();
+
+  /**
+  * \fn bool FlowField::GetStep(int row, int column, int &rowStep, int &columnStep) const
+  * \brief Gets the neighbour to step to from a cell to get closer to the target.
+  * \return false, with both steps 0, if the cell is on the target, can't reach it or is outside the field.
+  */
+  bool GetStep(int row, int column, int &rowStep, int &columnStep) const;
+
+  /**
+  * \fn int FlowField::GetDistance(int row, int column) const
+  * \brief Gets the number of steps from a cell to the target.
+  * \return -1 if the cell can't reach the target or is outside the field.
+  */
+  int GetDistance(int row, int column) const;
+
+  int GetTargetRow() const;
+  int GetTargetColumn() const;
+
+private:
+  friend class GridPathfinder;
+
+  int _rows, _columns;
+  int _firstRow, _firstColumn;
+  int _targetRow, _targetColumn;
+
+  // The map version the field was built against, 0 when it was never built.
+  Uint32 _mapVersion;
+
+  std::vector<Sint32> _distances;
+  std::vector<Uint8> _directions;
+};
+
+class GridPathfinder
+{
+public:
+  /**
+  * \fn GridPathfinder::GridPathfinder()
+  * \brief Creates an empty grid.
+  */
+  GridPathfinder();
+
+  /**
+  * \fn void GridPathfinder::Resize(int rows, int columns, int firstRow, int firstColumn)
+  * \brief Changes the size of the grid and makes every cell walkable. Reuses the grid's memory when it fits.
+  * \param firstRow, firstColumn The cell the grid starts at, every other function takes cells in the same coordinates.
+  */
+  void Resize(int rows, int columns, int firstRow = 0, int firstColumn = 0);
+
+  /**
+  * \fn void GridPathfinder::SetBlocked(int row, int column, bool blocked)
+  * \brief Makes a cell impassable, or walkable again. Cells outside the grid are ignored.
+  */
+  void SetBlocked(int row, int column, bool blocked);
+
+  bool IsBlocked(int row, int column) const;
+  bool Contains(int row, int column) const;
+
+  /**
+  * \fn bool GridPathfinder::FindPath(int startRow, int startColumn, int goalRow, int goalColumn, std::vector<GridCell> &path)
+  * \brief Finds a shortest path with A*.
+  * \param path Filled with the cells after the start up to and including the goal, empty if start and goal are
+  * the same cell. Its previous contents are dropped.
+  * \return false if either end is outside the grid or blocked, or the goal can't be reached.
+  */
+  bool FindPath(int startRow, int startColumn, int goalRow, int goalColumn, std::vector<GridCell> &path);
+
+  /**
+  * \fn bool GridPathfinder::UpdateFlowField(FlowField &field, int targetRow, int targetColumn)
+  * \brief Points every cell of a field toward the target, unless the field already is and the map didn't change
+  * since. Call it every tick, it only costs a pass over the grid when the target moved to another cell.
+  * \return true if the field was rebuilt.
+  */
+  bool UpdateFlowField(FlowField &field, int targetRow, int targetColumn);
+
+  /**
+  * \fn int GridPathfinder::GetVisitedCount() const
+  * \brief Gets the number of cells the last FindPath or flow field rebuild looked at, for profiling.
+  */
+  int GetVisitedCount() const;
+
+protected:
+  struct OpenNode
+  {
+    Sint32 estimate; // cost so far plus the distance left
+    Sint32 cost;
+    Sint32 cell;
+  };
+
+  int GetCell(int row, int column) const;
+
+  /**
+  * \fn void GridPathfinder::PushOpen(const OpenNode &node)
+  * \brief Adds a node to the open heap, the node with the lowest estimate is on top.
+  */
+  void PushOpen(const OpenNode &node);
+
+  /**
+  * \fn OpenNode GridPathfinder::PopOpen()
+  * \brief Takes the node with the lowest estimate off the open heap, preferring the one furthest along on ties.
+  */
+  OpenNode PopOpen();
+
+  static bool IsBefore(const OpenNode &a, const OpenNode &b);
+
+  int _rows, _columns;
+  int _firstRow, _firstColumn;
+  std::vector<Uint8> _blocked;
+
+  // Bumped whenever the map changes, so flow fields know to rebuild.
+  Uint32 _mapVersion;
+
+  // Per-cell search state, only valid where _generations matches _generation.
+  std::vector<Uint32> _generations;
+  std::vector<Sint32> _costs;
+  std::vector<Sint32> _parents;
+  Uint32 _generation;
+
+  // Reused by every search.
+  std::vector<OpenNode> _open;
+  std::vector<Sint32> _queue;
+  int _visitedCount;
+};
@@ -0,0 +1,162 @@
+#include "InputActionMap.h"
+#include "InputManager.h"
+
+InputActionMap::InputActionMap() : _isDirty(false) { }
+
+void InputActionMap::Bind(int action, SDL_Scancode key, SDL_Keymod modifiers)
+{
+  BindChord(action, key, SDL_SCANCODE_UNKNOWN, modifiers);
+}
+
+void InputActionMap::BindChord(int action, SDL_Scancode key, SDL_Scancode heldKey, SDL_Keymod modifiers)
+{
+  if (action < 0 || action >= kMaxActions)
+  {
+    return;
+  }
+
+  Binding binding = { action, key, heldKey, modifiers };
+  _bindings.push_back(binding);
+  _isDirty = true;
+}
+
+void InputActionMap::Unbind(int action)
+{
+  for (auto itr = _bindings.begin(); itr != _bindings.end();)
+  {
+    if (itr->action == action)
+    {
+      itr = _bindings.erase(itr);
+      _isDirty = true;
+    }
+    else
+    {
+      itr++;
+    }
+  }
+}
+
+void InputActionMap::Compile()
+{
+  _compiled.clear();
+  _compiled.reserve(_bindings.size());
+
+  for (auto itr = _bindings.begin(); itr != _bindings.end(); itr++)
+  {
+    CompiledBinding compiled;
+    compiled.key = (Uint16)itr->key;
+    compiled.heldKey = (Uint16)itr->heldKey;
+    compiled.modifierGroups = ToModifierGroups(itr->modifiers);
+    compiled.action = (Uint8)itr->action;
+    _compiled.push_back(compiled);
+  }
+
+  _isDirty = false;
+}
+
+void InputActionMap::Resolve(const InputManager *input)
+{
+  if (_isDirty)
+  {
+    Compile();
+  }
+
+  _actionsDown.reset();
+  _actionsPressed.reset();
+  _actionsReleased.reset();
+
+  Uint8 heldGroups = GetHeldModifierGroups(input);
+
+  for (auto itr = _compiled.begin(); itr != _compiled.end(); itr++)
+  {
+    const CompiledBinding &binding = *itr;
+
+    // Modifiers and chord keys gate the binding, the main key decides its state.
+    if ((heldGroups & binding.modifierGroups) != binding.modifierGroups)
+    {
+      continue;
+    }
+
+    if (binding.heldKey != SDL_SCANCODE_UNKNOWN && input->IsDown((SDL_Scancode)binding.heldKey) == false)
+    {
+      continue;
+    }
+
+    SDL_Scancode key = (SDL_Scancode)binding.key;
+    if (input->IsDown(key))
+    {
+      _actionsDown.set(binding.action);
+    }
+
+    if (input->WasPressed(key))
+    {
+      _actionsPressed.set(binding.action);
+    }
+
+    if (input->WasReleased(key))
+    {
+      _actionsReleased.set(binding.action);
+    }
+  }
+}
+
+bool InputActionMap::IsDown(int action) const
+{
+  return _actionsDown[action];
+}
+
+bool InputActionMap::WasPressed(int action) const
+{
+  return _actionsPressed[action];
+}
+
+bool InputActionMap::WasReleased(int action) const
+{
+  return _actionsReleased[action];
+}
+
+Uint8 InputActionMap::ToModifierGroups(SDL_Keymod modifiers)
+{
+  Uint8 groups = 0;
+  if (modifiers & KMOD_SHIFT)
+  {
+    groups |= MOD_SHIFT;
+  }
+  if (modifiers & KMOD_CTRL)
+  {
+    groups |= MOD_CTRL;
+  }
+  if (modifiers & KMOD_ALT)
+  {
+    groups |= MOD_ALT;
+  }
+  if (modifiers & KMOD_GUI)
+  {
+    groups |= MOD_GUI;
+  }
+
+  return groups;
+}
+
+Uint8 InputActionMap::GetHeldModifierGroups(const InputManager *input)
+{
+  Uint8 groups = 0;
+  if (input->IsDown(SDL_SCANCODE_LSHIFT) || input->IsDown(SDL_SCANCODE_RSHIFT))
+  {
+    groups |= MOD_SHIFT;
+  }
+  if (input->IsDown(SDL_SCANCODE_LCTRL) || input->IsDown(SDL_SCANCODE_RCTRL))
+  {
+    groups |= MOD_CTRL;
+  }
+  if (input->IsDown(SDL_SCANCODE_LALT) || input->IsDown(SDL_SCANCODE_RALT))
+  {
+    groups |= MOD_ALT;
+  }
+  if (input->IsDown(SDL_SCANCODE_LGUI) || input->IsDown(SDL_SCANCODE_RGUI))
+  {
+    groups |= MOD_GUI;
+  }
+
+  return groups;
+}
\ No newline at end of file
@@ -0,0 +1,123 @@
+/**
+ * \class InputActionMap
+ * \brief Maps gameplay actions to keys, modifiers and chords.
+ *
+ * Bindings are compiled into a flat table whenever they change. Each update, every action is
+ * resolved with a single pass over that table against the InputManager's key bits, after which
+ * querying an action is a bit test.
+ */
+
+#pragma once
+#include <SDL_keyboard.h>
+#include <bitset>
+#include <vector>
+
+class InputManager;
+
+class InputActionMap
+{
+public:
+  // Actions are small integers chosen by the game, eg. an enum starting at 0.
+  static const int kMaxActions = 64;
+
+  /**
+  * \fn InputActionMap::InputActionMap()
+  * \brief Creates an action map with no bindings.
+  */
+  InputActionMap();
+
+  /**
+  * \fn void InputActionMap::Bind(int action, SDL_Scancode key, SDL_Keymod modifiers)
+  * \brief Binds a key to an action. An action can have any number of bindings.
+  * \param action The action to bind, between 0 and kMaxActions - 1.
+  * \param key The key triggering the action.
+  * \param modifiers Modifiers that must be held as well, eg. KMOD_CTRL. Either side satisfies a modifier.
+  */
+  void Bind(int action, SDL_Scancode key, SDL_Keymod modifiers = KMOD_NONE);
+
+  /**
+  * \fn void InputActionMap::BindChord(int action, SDL_Scancode key, SDL_Scancode heldKey, SDL_Keymod modifiers)
+  * \brief Binds a chord to an action: the key only triggers the action while heldKey is down.
+  * \param action The action to bind, between 0 and kMaxActions - 1.
+  * \param key The key triggering the action.
+  * \param heldKey The key that must already be held.
+  * \param modifiers Modifiers that must be held as well.
+  */
+  void BindChord(int action, SDL_Scancode key, SDL_Scancode heldKey, SDL_Keymod modifiers = KMOD_NONE);
+
+  /**
+  * \fn void InputActionMap::Unbind(int action)
+  * \brief Removes every binding of an action.
+  */
+  void Unbind(int action);
+
+  /**
+  * \fn void InputActionMap::Resolve(const InputManager *input)
+  * \brief Recompiles the bindings if they changed, then updates the state of every action.
+  * Call once per update, after InputManager::Update.
+  * \param input The input manager holding this update's key bits.
+  */
+  void Resolve(const InputManager *input);
+
+  /**
+  * \fn bool InputActionMap::IsDown(int action) const
+  * \brief Gets whether or not any binding of the action is held.
+  */
+  bool IsDown(int action) const;
+
+  /**
+  * \fn bool InputActionMap::WasPressed(int action) const
+  * \brief Gets whether or not a binding of the action was pressed during the last update.
+  */
+  bool WasPressed(int action) const;
+
+  /**
+  * \fn bool InputActionMap::WasReleased(int action) const
+  * \brief Gets whether or not a binding of the action was released during the last update.
+  */
+  bool WasReleased(int action) const;
+
+protected:
+  // Modifier groups, either side of the keyboard counts.
+  enum ModifierGroup
+  {
+    MOD_SHIFT = 1 << 0,
+    MOD_CTRL = 1 << 1,
+    MOD_ALT = 1 << 2,
+    MOD_GUI = 1 << 3
+  };
+
+  struct Binding
+  {
+    int action;
+    SDL_Scancode key;
+    SDL_Scancode heldKey;
+    SDL_Keymod modifiers;
+  };
+
+  // What Resolve walks: packed, with modifiers already reduced to groups.
+  struct CompiledBinding
+  {
+    Uint16 key;
+    Uint16 heldKey;
+    Uint8 modifierGroups;
+    Uint8 action;
+  };
+
+  /**
+  * \fn void InputActionMap::Compile()
+  * \brief Rebuilds the compiled table from the bindings.
+  */
+  void Compile();
+
+  static Uint8 ToModifierGroups(SDL_Keymod modifiers);
+  static Uint8 GetHeldModifierGroups(const InputManager *input);
+
+  std::vector<Binding> _bindings;
+  std::vector<CompiledBinding> _compiled;
+  bool _isDirty;
+
+  std::bitset<kMaxActions> _actionsDown;
+  std::bitset<kMaxActions> _actionsPressed;
+  std::bitset<kMaxActions> _actionsReleased;
+};
\ No newline at end of file
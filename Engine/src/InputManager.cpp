@@ -1,30 +1,8 @@
 #include "InputManager.h"
-
-class InputBlock
-{
-public:
-  InputBlock(InputEvent callback) : callback(callback) { }
-  void ProcessInput(SDL_Event e)
-  {
-    (*callback)(e);
-  }
-
-  InputEvent callback;
-
-};
-
-struct InputPair
-{
-  void *target;
-  InputMemberEvent callback;
-
-  InputPair(void *target, InputMemberEvent callback) : target(target), callback(callback) { }
-  void ProcessInput(SDL_Event e)
-  {
-    IInput *castedTarget = (IInput *)target;
-    (castedTarget->*callback)(e);
-  }
-};
+#include <SDL_keyboard.h>
+#include <SDL_timer.h>
+#include <stdio.h>
+#include <string.h>
 
 InputManager* InputManager::_instance = NULL;
 
@@ -47,239 +25,322 @@ void InputManager::DestroyInstance()
   }
 }
 
-InputManager::InputManager() { }
-InputManager::~InputManager() { }
+InputManager::InputManager() :
+_slotCount(0),
+_dispatchDepth(0),
+_updateTime(0),
+_sampler(nullptr),
+_recorder(nullptr)
+{
+  memset(_slotForType, 0, sizeof(_slotForType));
+  memset(_keyTimes, 0, sizeof(_keyTimes));
+}
+
+InputManager::~InputManager()
+{
+  delete _sampler;
+}
 
 void InputManager::AssignEvent(SDL_EventType evt, InputEvent callback)
 {
-  InputBlock *newBlock = new InputBlock(callback);
+  AssignEvent(evt, InputDelegate::FromFunction(callback));
+}
 
-  auto mapItr = _eventMap.find(evt);
-  if (mapItr == _eventMap.end())
+void InputManager::AssignEvent(SDL_EventType evt, const InputDelegate &callback)
+{
+  int slotIndex = _slotForType[evt & SDL_LASTEVENT] - 1;
+  if (slotIndex < 0)
   {
-    std::vector<InputBlock *> newEntry;
-    newEntry.push_back(newBlock);
+    // First callback for this event type, give it a slot of its own.
+    if (_slotCount == kMaxEventSlots)
+    {
+      printf("InputManager: no slot left for event type 0x%x\n", evt);
+      return;
+    }
 
-    std::pair<SDL_EventType, std::vector<InputBlock *> > newPair(evt, newEntry);
-    _eventMap.insert(newPair);
+    slotIndex = _slotCount++;
+    _slots[slotIndex].count = 0;
+    _slots[slotIndex].needsCompact = false;
+    _slotForType[evt & SDL_LASTEVENT] = (Uint8)(slotIndex + 1);
   }
-  else
+
+  EventSlot &slot = _slots[slotIndex];
+  for (int i = 0; i < slot.count; i++)
   {
-    bool found = false;
-    std::vector<InputBlock *> &events = mapItr->second;
-    for (auto itr = events.begin(); itr != events.end(); itr++)
+    if (slot.callbacks[i] == callback)
     {
-      InputBlock *currentBlock = (*itr);
-      if (currentBlock->callback == callback)
-      {
-        /* If the block already exists in our list, we want to remove it.*/
-        found = true;
-        delete newBlock;
-        break;
-      }
+      /* If the callback is already assigned, there is nothing to do. */
+      return;
     }
+  }
 
-    if (found == false)
-    {
-      events.push_back(newBlock);
-    }
+  if (slot.count == kMaxCallbacksPerSlot)
+  {
+    printf("InputManager: too many callbacks for event type 0x%x\n", evt);
+    return;
   }
+
+  slot.callbacks[slot.count++] = callback;
 }
 
-void InputManager::AssignEvent(SDL_EventType evt, void *target, InputMemberEvent callback)
+void InputManager::RemoveEvent(SDL_EventType evt, InputEvent callback)
 {
-  IInput *castedTarget = (IInput *)target;
-
-  InputPair *newPair = new InputPair(castedTarget, callback);
+  RemoveEvent(evt, InputDelegate::FromFunction(callback));
+}
 
-  auto mapItr = _memberEventMap.find(evt);
-  if (mapItr == _memberEventMap.end())
+void InputManager::RemoveEvent(SDL_EventType evt, const InputDelegate &callback)
+{
+  int slotIndex = _slotForType[evt & SDL_LASTEVENT] - 1;
+  if (slotIndex < 0)
   {
-    std::vector<InputPair *> newPairEntry;
-    newPairEntry.push_back(newPair);
-
-    std::pair<SDL_EventType, std::vector<InputPair *> > newEntry(evt, newPairEntry);
-    _memberEventMap.insert(newEntry);
+    return;
   }
-  else
+
+  EventSlot &slot = _slots[slotIndex];
+  for (int i = 0; i < slot.count; i++)
   {
-    bool found = false;
-    std::vector<InputPair *> &events = mapItr->second;
-    for (auto itr = events.begin(); itr != events.end(); itr++)
+    if (slot.callbacks[i] == callback)
     {
-      InputPair *currentPair = (*itr);
-      if (currentPair->target == target && currentPair->callback == callback)
-      {
-        found = true;
-        delete newPair;
-        break;
-      }
+      // Leave a gap rather than shifting callbacks under a running dispatch.
+      slot.callbacks[i] = InputDelegate();
+      slot.needsCompact = true;
+      break;
     }
+  }
 
-    if (found == false)
-    {
-      events.push_back(newPair);
-    }
+  if (_dispatchDepth == 0)
+  {
+    CompactSlot(slot);
   }
 }
 
-void InputManager::RemoveEvent(SDL_EventType evt, InputEvent callback)
+void InputManager::CompactSlot(EventSlot &slot)
 {
-  auto mapItr = _eventMap.find(evt);
-  if (mapItr != _eventMap.end())
+  if (slot.needsCompact == false)
   {
-    bool found = false;
-    std::vector<InputBlock *> &events = mapItr->second;
+    return;
+  }
 
-    auto itr = events.begin();
-    for (; itr != events.end(); itr++)
+  int write = 0;
+  for (int read = 0; read < slot.count; read++)
+  {
+    if (slot.callbacks[read].IsBound())
     {
-      InputBlock *currentBlock = (*itr);
-      if (currentBlock->callback == callback)
-      {
-        found = true;
-        break;
-      }
+      slot.callbacks[write++] = slot.callbacks[read];
     }
+  }
 
-    if (found == true)
-    {
-      delete (*itr);
-      events.erase(itr);
-
-      // If there aren't any more events for this key, remove it.
-      if (events.empty() == true)
-      {
-        _eventMap.erase(evt);
-      }
-    }
+  slot.count = write;
+  slot.needsCompact = false;
+}
+
+void InputManager::ProcessEvent(const SDL_Event &e)
+{
+  int slotIndex = _slotForType[e.type & SDL_LASTEVENT] - 1;
+  if (slotIndex < 0)
+  {
+    return;
+  }
+
+  EventSlot &slot = _slots[slotIndex];
+
+  // Callbacks assigned while dispatching are only called from the next event on.
+  int count = slot.count;
+
+  _dispatchDepth++;
+  for (int i = 0; i < count; i++)
+  {
+    slot.callbacks[i](e);
+  }
+  _dispatchDepth--;
+
+  if (_dispatchDepth == 0)
+  {
+    CompactSlot(slot);
   }
 }
 
-void InputManager::RemoveEvent(SDL_EventType evt, void *target, InputMemberEvent callback)
+void InputManager::Update(float dt)
 {
-  auto mapItr = _memberEventMap.find(evt);
-  if (mapItr != _memberEventMap.end())
+  // Edges only last for the update they happened in.
+  _keysPressed.reset();
+  _keysReleased.reset();
+
+  if (_recorder != nullptr && _recorder->GetMode() == InputRecorder::MODE_REPLAYING)
   {
-    bool found = false;
-    std::vector<InputPair *> &events = mapItr->second;
+    // Live input is ignored, the tick's events come from the log.
+    _updateTime = SDL_GetPerformanceCounter();
+    for (int i = 0; i < _recorder->GetTickEventCount(); i++)
+    {
+      HandleEvent(_recorder->GetTickEvent(i), _updateTime);
+    }
+
+    return;
+  }
 
-    auto itr = events.begin();
-    for (; itr != events.end(); itr++)
+  if (_sampler != nullptr)
+  {
+    _sampler->Pump();
+    _updateTime = SDL_GetPerformanceCounter();
+
+    TimedEvent timedEvent;
+    while (_sampler->Pop(timedEvent))
     {
-      InputPair *currentPair = (*itr);
-      if (currentPair->target == target && currentPair->callback == callback)
-      {
-        found = true;
-        break;
-      }
+      HandleEvent(timedEvent.event, timedEvent.timestamp);
     }
 
-    if (found == true)
+    // What the sampler didn't take (events pushed from other threads, or ones that came while its queue was full)
+    // is still in SDL's queue and is newer than what was just handled.
+    _sampler->ResumeAfterOverflow();
+    _eventBatch.Drain(false);
+    for (int i = 0; i < _eventBatch.GetCount(); i++)
     {
-      delete (*itr);
-      events.erase(itr);
-
-      // If there aren't any more events for this key, remove it.
-      if (events.empty() == true)
-      {
-        _memberEventMap.erase(evt);
-      }
+      HandleEvent(_eventBatch.GetEvent(i), _updateTime);
     }
+    return;
+  }
+
+  // Take everything that queued up since the last frame, so input never lags behind by more than a frame.
+  _eventBatch.Drain();
+  _updateTime = SDL_GetPerformanceCounter();
+
+  for (int i = 0; i < _eventBatch.GetCount(); i++)
+  {
+    HandleEvent(_eventBatch.GetEvent(i), _updateTime);
   }
 }
 
-void InputManager::ProcessEvent(SDL_Event e)
+void InputManager::HandleEvent(const SDL_Event &evt, Uint64 timestamp)
 {
-  SDL_EventType evt = (SDL_EventType)e.type;
-  auto mapItr = _eventMap.find(evt);
-  if (mapItr != _eventMap.end())
+  UpdateKeyState(evt, timestamp);
+
+  if (_recorder != nullptr)
   {
-    std::vector<InputBlock *> events = mapItr->second;
-    for (auto itr = events.begin(); itr != events.end(); itr++)
-    {
-      (*itr)->ProcessInput(e);
-    }
+    _recorder->RecordEvent(evt);
+  }
+
+  // Process any method we've got assigned.
+  ProcessEvent(evt);
+}
+
+void InputManager::SetRecorder(InputRecorder *recorder)
+{
+  _recorder = recorder;
+}
+
+void InputManager::EnableSampling()
+{
+  // A replay doesn't read live input, so there is nothing to sample.
+  if (_sampler != nullptr || (_recorder != nullptr && _recorder->GetMode() == InputRecorder::MODE_REPLAYING))
+  {
+    return;
   }
 
-  auto memberMapItr = _memberEventMap.find(evt);
-  if (memberMapItr != _memberEventMap.end())
+  _sampler = new InputSampler();
+  if (_sampler->Start() == false)
   {
-    std::vector<InputPair *> events = memberMapItr->second;
-    for (auto itr = events.begin(); itr != events.end(); itr++)
-    {
-      (*itr)->ProcessInput(e);
-    }
+    delete _sampler;
+    _sampler = nullptr;
   }
 }
 
-void InputManager::Update(float dt)
+void InputManager::DisableSampling()
 {
-  SDL_Event evt;
-  SDL_PollEvent(&evt);
+  if (_sampler == nullptr)
+  {
+    return;
+  }
 
-  for (auto keysToRemoveItr = _keysToRemove.begin(); keysToRemoveItr != _keysToRemove.end(); keysToRemoveItr++)
+  // Whatever was sampled but not consumed yet goes back to SDL's queue.
+  _sampler->Stop();
+
+  delete _sampler;
+  _sampler = nullptr;
+}
+
+void InputManager::Sample()
+{
+  if (_sampler != nullptr)
   {
-    auto keyMapItr = _keyMap.find(keysToRemoveItr->first);
-    _keyMap.erase(keyMapItr);
-    //printf("KEY ERASED %d\n", _keyMap.size());
+    _sampler->Pump();
   }
-  _keysToRemove.clear();
+}
 
-  // Check to see if we already have an entry in our map.
+void InputManager::UpdateKeyState(const SDL_Event &evt, Uint64 timestamp)
+{
   if (evt.type == SDL_KEYDOWN)
   {
-    SDL_Keycode &pressedKey = evt.key.keysym.sym;
-    auto keyMapItr = _keyMap.find(pressedKey);
-    
-    // If we don't already have it in our map, let's add it!
-    if (keyMapItr == _keyMap.end())
-    {
-      std::pair<SDL_Keycode, SDL_EventType> keyPair(pressedKey, SDL_KEYDOWN);
-      _keyMap.insert(keyPair);
+    SDL_Scancode scancode = evt.key.keysym.scancode;
 
-      //printf("KEY DOWN %d\n", _keyMap.size());
+    // Key repeats arrive as more SDL_KEYDOWN events, only the first one is a press.
+    if (_keysDown[scancode] == false)
+    {
+      _keysDown.set(scancode);
+      _keysPressed.set(scancode);
+      _keyTimes[scancode] = timestamp;
     }
   }
   else if (evt.type == SDL_KEYUP)
   {
-    SDL_Keycode &pressedKey = evt.key.keysym.sym;
-    auto keyMapItr = _keyMap.find(pressedKey);
-
-    // If we have it in our map, let's remove it!
-    if (keyMapItr != _keyMap.end())
+    SDL_Scancode scancode = evt.key.keysym.scancode;
+    if (_keysDown[scancode] == true)
     {
-      keyMapItr->second = SDL_KEYUP;
-      _keysToRemove.push_back(*keyMapItr);
-
-      //printf("KEY UP %d\n", _keyMap.size());
+      _keysDown.reset(scancode);
+      _keysReleased.set(scancode);
+      _keyTimes[scancode] = timestamp;
     }
   }
+}
 
-  // Process any method we've got assigned.
-  ProcessEvent(evt);
+bool InputManager::IsDown(SDL_Scancode scancode) const
+{
+  return _keysDown[scancode];
+}
+
+bool InputManager::WasPressed(SDL_Scancode scancode) const
+{
+  return _keysPressed[scancode];
+}
+
+bool InputManager::WasReleased(SDL_Scancode scancode) const
+{
+  return _keysReleased[scancode];
+}
+
+Uint64 InputManager::GetKeyTime(SDL_Scancode scancode) const
+{
+  return _keyTimes[scancode];
+}
+
+float InputManager::GetTimeSinceKeyChanged(SDL_Scancode scancode) const
+{
+  Uint64 keyTime = _keyTimes[scancode];
+  if (keyTime == 0 || keyTime >= _updateTime)
+  {
+    return 0.0f;
+  }
+
+  return (float)((double)(_updateTime - keyTime) / (double)SDL_GetPerformanceFrequency());
 }
 
 bool InputManager::IsKeyDown(SDL_Keycode keycode)
 {
-  return GetKeyState(keycode, SDL_KEYDOWN);
+  return IsDown(SDL_GetScancodeFromKey(keycode));
 }
 
 bool InputManager::GetKeyState(SDL_Keycode keycode, SDL_EventType eventType)
 {
-  bool doesKeyMatch = false;
-  auto keyMapItr = _keyMap.find(keycode);
+  SDL_Scancode scancode = SDL_GetScancodeFromKey(keycode);
 
-  // If we find an entry, then let's see if it matches.
-  if (keyMapItr != _keyMap.end())
+  // A key is in the SDL_KEYUP state for the update it was released in.
+  if (eventType == SDL_KEYDOWN)
   {
-    SDL_EventType &mappedEvent = keyMapItr->second;
-    if (mappedEvent == eventType)
-    {
-      doesKeyMatch = true;
-    }
+    return IsDown(scancode);
+  }
+  else if (eventType == SDL_KEYUP)
+  {
+    return WasReleased(scancode);
   }
 
-  return doesKeyMatch;
+  return false;
 }
-
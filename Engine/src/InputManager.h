@@ -6,17 +6,15 @@
  */
 
 #pragma once
+#include "Delegate.h"
+#include "EventBatch.h"
+#include "InputSampler.h"
+#include "InputRecorder.h"
 #include <SDL_events.h>
-#include <map>
-#include <vector>
+#include <bitset>
 
-// A feign class we use to use to trick the system into providing callback support with member functions.
-class IInput { };
-typedef void(*InputEvent)(SDL_Event e);
-typedef void(IInput::*InputMemberEvent)(SDL_Event e);
-
-class InputBlock;
-struct InputPair;
+typedef void(*InputEvent)(const SDL_Event &e);
+typedef Delegate<const SDL_Event &> InputDelegate;
 
 class InputManager
 {
@@ -49,13 +47,26 @@ public:
   void AssignEvent(SDL_EventType evt, InputEvent callback);
 
   /**
-  * \fn void InputManager::AssignEvent(SDL_EventType evt, void *target, InputMemberEvent callback)
-  * \brief Assigns the given callback function to be called when the given event is triggered.
+  * \fn void InputManager::AssignEvent<T, Method>(SDL_EventType evt, T *target)
+  * \brief Assigns the given member function to be called on the target when the given event is triggered.
+  * eg. AssignEvent<Player, &Player::OnKeyDown>(SDL_KEYDOWN, player);
   * \param evt The event type to listen for.
   * \param target The object that we want to call the callback function on.
-  * \param callback The member callback to fire when the event is fired.
   */
-  void AssignEvent(SDL_EventType evt, void *target, InputMemberEvent callback);
+  template <class T, void (T::*Method)(const SDL_Event &)>
+  void AssignEvent(SDL_EventType evt, T *target)
+  {
+    AssignEvent(evt, InputDelegate::FromMethod<T, Method>(target));
+  }
+
+  /**
+  * \fn void InputManager::AssignEvent(SDL_EventType evt, const InputDelegate &callback)
+  * \brief Assigns the given delegate to be called when the given event is triggered.
+  * Assigning a delegate that is already assigned to the event does nothing.
+  * \param evt The event type to listen for.
+  * \param callback The delegate to fire when the event is fired.
+  */
+  void AssignEvent(SDL_EventType evt, const InputDelegate &callback);
 
   /**
   * \fn void InputManager::RemoveEvent(SDL_EventType evt, InputEvent callback)
@@ -66,24 +77,106 @@ public:
   void RemoveEvent(SDL_EventType evt, InputEvent callback);
 
   /**
-  * \fn void InputManager::RemoveEvent(SDL_EventType evt, void *target, InputMemberEvent callback)
-  * \brief Unassigns the given callback function.
+  * \fn void InputManager::RemoveEvent<T, Method>(SDL_EventType evt, T *target)
+  * \brief Unassigns the given member function.
   * \param evt The event type to remove.
   * \param target The object that we assigned the callback to.
-  * \param callback The static callback that was assigned with the event.
   */
-  void RemoveEvent(SDL_EventType evt, void *target, InputMemberEvent callback);
+  template <class T, void (T::*Method)(const SDL_Event &)>
+  void RemoveEvent(SDL_EventType evt, T *target)
+  {
+    RemoveEvent(evt, InputDelegate::FromMethod<T, Method>(target));
+  }
+
+  /**
+  * \fn void InputManager::RemoveEvent(SDL_EventType evt, const InputDelegate &callback)
+  * \brief Unassigns the given delegate. Safe to call from inside a callback.
+  * \param evt The event type to remove.
+  * \param callback The delegate that was assigned with the event.
+  */
+  void RemoveEvent(SDL_EventType evt, const InputDelegate &callback);
 
   /**
   * \fn void InputManager::Update(float dt)
-  * \brief Updates the InputManager.
+  * \brief Updates the InputManager, processing every event queued since the last update.
   * \param dt The time since the last update.
   */
   void Update(float dt);
 
+  /**
+  * \fn void InputManager::SetRecorder(InputRecorder *recorder)
+  * \brief Sets the recorder every processed event is logged to, or replayed from.
+  * While the recorder is replaying, the events of its current tick replace live input entirely.
+  * \param recorder The recorder, NULL for live input only. The InputManager does not take ownership.
+  */
+  void SetRecorder(InputRecorder *recorder);
+
+  /**
+  * \fn void InputManager::EnableSampling()
+  * \brief Takes events from an InputSampler, stamped when the game thread pumped them, ahead of what is left in
+  * SDL's queue each update. Call Sample mid-frame for tighter stamps.
+  */
+  void EnableSampling();
+
+  /**
+  * \fn void InputManager::DisableSampling()
+  * \brief Goes back to draining SDL's queue each update.
+  */
+  void DisableSampling();
+
+  /**
+  * \fn void InputManager::Sample()
+  * \brief Gives the sampler a chance to stamp pending events now rather than at the next update.
+  * Cheap to call mid-frame, eg. before a blocking buffer swap. Does nothing when not sampling.
+  */
+  void Sample();
+
+  /**
+  * \fn Uint64 InputManager::GetKeyTime(SDL_Scancode scancode) const
+  * \brief Gets when the given key last went down or up, on the SDL_GetPerformanceCounter clock. That is when the
+  * event was pumped while sampling, when the update started otherwise.
+  * \param scancode The physical key we want to check.
+  * \return The time of the key's last change, 0 if it never changed.
+  */
+  Uint64 GetKeyTime(SDL_Scancode scancode) const;
+
+  /**
+  * \fn float InputManager::GetTimeSinceKeyChanged(SDL_Scancode scancode) const
+  * \brief Gets how long before the current update the given key last went down or up.
+  * Lets gameplay place an action inside the frame rather than at the frame boundary.
+  * \param scancode The physical key we want to check.
+  * \return The time in seconds, never negative.
+  */
+  float GetTimeSinceKeyChanged(SDL_Scancode scancode) const;
+
+  /**
+  * \fn bool InputManager::IsDown(SDL_Scancode scancode) const
+  * \brief Gets whether or not the given key is currently held down.
+  * \param scancode The physical key we want to check.
+  * \return Whether or not the key is down (true/false).
+  */
+  bool IsDown(SDL_Scancode scancode) const;
+
+  /**
+  * \fn bool InputManager::WasPressed(SDL_Scancode scancode) const
+  * \brief Gets whether or not the given key went down during the last update.
+  * \param scancode The physical key we want to check.
+  * \return Whether or not the key was pressed (true/false). Key repeats don't count as presses.
+  */
+  bool WasPressed(SDL_Scancode scancode) const;
+
+  /**
+  * \fn bool InputManager::WasReleased(SDL_Scancode scancode) const
+  * \brief Gets whether or not the given key went up during the last update.
+  * \param scancode The physical key we want to check.
+  * \return Whether or not the key was released (true/false).
+  */
+  bool WasReleased(SDL_Scancode scancode) const;
+
   /**
   * \fn void InputManager::IsKeyDown(SDL_Keycode keycode)
   * \brief Gets whether or not the given key is down (being pressed).
+  * Prefer IsDown, this has to translate the keycode to a scancode first.
   * \param keycode The keycode for the key we want to check.
   * \return Whether or not the given key is down (true/false).
   */
@@ -92,6 +185,7 @@ public:
   /**
   * \fn void InputManager::GetKeyState(SDL_Keycode keycode, SDL_EventType eventType)
   * \brief Gets whether or not the given key is in the provided state.
+  * Prefer IsDown/WasReleased, this has to translate the keycode to a scancode first.
   * \param keycode The keycode for the key we want to check.
   * \param eventType The status we want to check against (eg. SDL_KEYDOWN/SDL_KEYUP).
   * \return Whether or not the given key is in the provided state (true/false).
@@ -106,16 +200,71 @@ protected:
   InputManager();
 
   /**
-  * \fn void InputManager::ProcessEvent(SDL_Event evt)
+  * \fn void InputManager::ProcessEvent(const SDL_Event &evt)
   * \brief Process the given SDL event.
   * \param evt An SDL event we want to process, and check against triggers for.
   */
-  void ProcessEvent(SDL_Event evt);
+  void ProcessEvent(const SDL_Event &evt);
+
+  /**
+  * \fn void InputManager::HandleEvent(const SDL_Event &evt, Uint64 timestamp)
+  * \brief Updates the key bits from an event, logs it if recording, and dispatches it to the callbacks.
+  * \param evt The event to handle.
+  * \param timestamp When the event was sampled, on the SDL_GetPerformanceCounter clock.
+  */
+  void HandleEvent(const SDL_Event &evt, Uint64 timestamp);
+
+  /**
+  * \fn void InputManager::UpdateKeyState(const SDL_Event &evt, Uint64 timestamp)
+  * \brief Updates the key bits from a keyboard event.
+  * \param evt An SDL event, anything but SDL_KEYDOWN/SDL_KEYUP is ignored.
+  * \param timestamp When the event was sampled, on the SDL_GetPerformanceCounter clock.
+  */
+  void UpdateKeyState(const SDL_Event &evt, Uint64 timestamp);
+
+  // Distinct event types that can have callbacks, and callbacks per event type.
+  static const int kMaxEventSlots = 32;
+  static const int kMaxCallbacksPerSlot = 8;
+
+  struct EventSlot
+  {
+    InputDelegate callbacks[kMaxCallbacksPerSlot];
+    int count;
+    bool needsCompact;
+  };
+
+  /**
+  * \fn void InputManager::CompactSlot(EventSlot &slot)
+  * \brief Closes the gaps left by callbacks removed while the slot was being dispatched.
+  * \param slot The slot to compact.
+  */
+  void CompactSlot(EventSlot &slot);
 
   static InputManager *_instance;
-  std::map<SDL_EventType, std::vector<InputBlock *> > _eventMap;
-  std::map<SDL_EventType, std::vector<InputPair *> > _memberEventMap;
 
-  std::map<SDL_Keycode, SDL_EventType> _keyMap;
-  std::vector<std::pair<SDL_Keycode, SDL_EventType> > _keysToRemove;
+  // Dispatch table: event type -> slot index + 1 (0 means no callbacks), covering every SDL event type.
+  // A dispatch reads a single byte of it.
+  Uint8 _slotForType[SDL_LASTEVENT + 1];
+  EventSlot _slots[kMaxEventSlots];
+  int _slotCount;
+
+  // Callbacks removed while a dispatch is running leave gaps that are compacted once it finishes.
+  int _dispatchDepth;
+
+  // One bit per scancode: held this update, went down this update, went up this update.
+  // The edges are latched from the events rather than diffed, so a tap shorter than a frame isn't lost.
+  std::bitset<SDL_NUM_SCANCODES> _keysDown;
+  std::bitset<SDL_NUM_SCANCODES> _keysPressed;
+  std::bitset<SDL_NUM_SCANCODES> _keysReleased;
+
+  // When each key last changed, and when the current update started.
+  Uint64 _keyTimes[SDL_NUM_SCANCODES];
+  Uint64 _updateTime;
+
+  EventBatch _eventBatch;
+
+  // Set while sampling, events then come from here first and _eventBatch only gets what it left in SDL's queue.
+  InputSampler *_sampler;
+
+  InputRecorder *_recorder;
 };
\ No newline at end of file
@@ -0,0 +1,397 @@
+#include "InputRecorder.h"
+#include <string.h>
+
+// "CBIR", then the format version. Bump the version whenever the layout of a tick changes.
+static const Uint32 kLogMagic = 0x52494243;
+static const Uint16 kLogVersion = 2;
+
+// Mouse coordinates are stored in 16 bits, plenty for any window.
+static Uint16 PackCoordinate(Sint32 value)
+{
+  if (value < -32768)
+  {
+    value = -32768;
+  }
+  else if (value > 32767)
+  {
+    value = 32767;
+  }
+  return (Uint16)(Sint16)value;
+}
+
+static Sint32 UnpackCoordinate(Uint16 value)
+{
+  return (Sint16)value;
+}
+
+InputRecorder::InputRecorder() :
+_file(nullptr),
+_mode(MODE_IDLE),
+_seed(0),
+_tickIndex(0),
+_tickDeltaTime(0.0f)
+{
+  _tickEvents.reserve(64);
+  _tickBytes.reserve(1024);
+}
+
+InputRecorder::~InputRecorder()
+{
+  Stop();
+}
+
+bool InputRecorder::StartRecording(const char *path, Uint32 seed)
+{
+  Stop();
+
+  _file = fopen(path, "wb");
+  if (_file == nullptr)
+  {
+    printf("InputRecorder: could not create %s\n", path);
+    return false;
+  }
+
+  _mode = MODE_RECORDING;
+  _seed = seed;
+  _tickIndex = 0;
+
+  _tickBytes.clear();
+  Put32(kLogMagic);
+  Put16(kLogVersion);
+  Put16(0);
+  Put32(seed);
+  fwrite(&_tickBytes[0], 1, _tickBytes.size(), _file);
+  _tickBytes.clear();
+  return true;
+}
+
+bool InputRecorder::StartReplay(const char *path)
+{
+  Stop();
+
+  _file = fopen(path, "rb");
+  if (_file == nullptr)
+  {
+    printf("InputRecorder: could not open %s\n", path);
+    return false;
+  }
+
+  Uint32 magic = 0, seed = 0;
+  Uint16 version = 0, reserved = 0;
+  if (Get32(magic) == false || Get16(version) == false || Get16(reserved) == false || Get32(seed) == false ||
+    magic != kLogMagic || version != kLogVersion)
+  {
+    printf("InputRecorder: %s is not an input log of version %d\n", path, kLogVersion);
+    fclose(_file);
+    _file = nullptr;
+    return false;
+  }
+
+  _mode = MODE_REPLAYING;
+  _seed = seed;
+  _tickIndex = 0;
+  return true;
+}
+
+void InputRecorder::Stop()
+{
+  if (_file != nullptr)
+  {
+    fclose(_file);
+    _file = nullptr;
+  }
+
+  _mode = MODE_IDLE;
+  _tickEvents.clear();
+}
+
+InputRecorder::Mode InputRecorder::GetMode() const
+{
+  return _mode;
+}
+
+Uint32 InputRecorder::GetSeed() const
+{
+  return _seed;
+}
+
+void InputRecorder::BeginTick(float dt)
+{
+  if (_mode != MODE_RECORDING)
+  {
+    return;
+  }
+
+  _tickDeltaTime = dt;
+  _tickEvents.clear();
+}
+
+void InputRecorder::RecordEvent(const SDL_Event &evt)
+{
+  // Only the input the engine acts on is logged, the rest (window, drop, user events...) can't be replayed anyway.
+  if (_mode == MODE_RECORDING && IsRecordable(evt))
+  {
+    _tickEvents.push_back(evt);
+  }
+}
+
+void InputRecorder::EndTick()
+{
+  if (_mode != MODE_RECORDING)
+  {
+    return;
+  }
+
+  WriteTick();
+  _tickIndex++;
+}
+
+void InputRecorder::WriteTick()
+{
+  _tickBytes.clear();
+
+  Uint32 dtBits;
+  memcpy(&dtBits, &_tickDeltaTime, sizeof(dtBits));
+  Put32(dtBits);
+  Put16((Uint16)_tickEvents.size());
+
+  for (auto itr = _tickEvents.begin(); itr != _tickEvents.end(); itr++)
+  {
+    const SDL_Event &evt = *itr;
+    switch (evt.type)
+    {
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+      Put8(evt.type == SDL_KEYDOWN ? RECORD_KEY_DOWN : RECORD_KEY_UP);
+      Put8(evt.key.repeat);
+      Put16((Uint16)evt.key.keysym.scancode);
+      Put32((Uint32)evt.key.keysym.sym);
+      Put16(evt.key.keysym.mod);
+      break;
+    case SDL_MOUSEMOTION:
+      Put8(RECORD_MOUSE_MOTION);
+      Put8(evt.motion.which == SDL_TOUCH_MOUSEID ? 1 : 0);
+      Put8((Uint8)evt.motion.state);
+      Put16(PackCoordinate(evt.motion.x));
+      Put16(PackCoordinate(evt.motion.y));
+      Put16(PackCoordinate(evt.motion.xrel));
+      Put16(PackCoordinate(evt.motion.yrel));
+      break;
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+      Put8(evt.type == SDL_MOUSEBUTTONDOWN ? RECORD_MOUSE_BUTTON_DOWN : RECORD_MOUSE_BUTTON_UP);
+      Put8(evt.button.which == SDL_TOUCH_MOUSEID ? 1 : 0);
+      Put8(evt.button.button);
+      Put8(evt.button.clicks);
+      Put16(PackCoordinate(evt.button.x));
+      Put16(PackCoordinate(evt.button.y));
+      break;
+    case SDL_MOUSEWHEEL:
+      Put8(RECORD_MOUSE_WHEEL);
+      Put8(evt.wheel.which == SDL_TOUCH_MOUSEID ? 1 : 0);
+      Put16(PackCoordinate(evt.wheel.x));
+      Put16(PackCoordinate(evt.wheel.y));
+      break;
+    case SDL_QUIT:
+      Put8(RECORD_QUIT);
+      break;
+    }
+  }
+
+  fwrite(&_tickBytes[0], 1, _tickBytes.size(), _file);
+}
+
+bool InputRecorder::ReadTick(float &dt)
+{
+  _tickEvents.clear();
+  if (_mode != MODE_REPLAYING)
+  {
+    return false;
+  }
+
+  Uint32 dtBits;
+  Uint16 count;
+  if (Get32(dtBits) == false || Get16(count) == false)
+  {
+    return false;
+  }
+
+  memcpy(&_tickDeltaTime, &dtBits, sizeof(dtBits));
+
+  for (int i = 0; i < count; i++)
+  {
+    Uint8 type;
+    if (Get8(type) == false)
+    {
+      return false;
+    }
+
+    SDL_Event evt;
+    memset(&evt, 0, sizeof(evt));
+    if (ReadEvent(type, evt) == false)
+    {
+      return false;
+    }
+
+    _tickEvents.push_back(evt);
+  }
+
+  dt = _tickDeltaTime;
+  _tickIndex++;
+  return true;
+}
+
+bool InputRecorder::ReadEvent(Uint8 type, SDL_Event &evt)
+{
+  Uint8 touch, state, button, clicks;
+  Uint16 x, y, xrel, yrel;
+  switch (type)
+  {
+  case RECORD_KEY_DOWN:
+  case RECORD_KEY_UP:
+  {
+    Uint8 repeat;
+    Uint16 scancode, mod;
+    Uint32 sym;
+    if (Get8(repeat) == false || Get16(scancode) == false || Get32(sym) == false || Get16(mod) == false)
+    {
+      return false;
+    }
+
+    evt.type = (type == RECORD_KEY_DOWN) ? SDL_KEYDOWN : SDL_KEYUP;
+    evt.key.state = (type == RECORD_KEY_DOWN) ? SDL_PRESSED : SDL_RELEASED;
+    evt.key.repeat = repeat;
+    evt.key.keysym.scancode = (SDL_Scancode)scancode;
+    evt.key.keysym.sym = (SDL_Keycode)sym;
+    evt.key.keysym.mod = mod;
+    return true;
+  }
+  case RECORD_MOUSE_MOTION:
+    if (Get8(touch) == false || Get8(state) == false || Get16(x) == false || Get16(y) == false ||
+      Get16(xrel) == false || Get16(yrel) == false)
+    {
+      return false;
+    }
+
+    evt.type = SDL_MOUSEMOTION;
+    evt.motion.which = touch ? SDL_TOUCH_MOUSEID : 0;
+    evt.motion.state = state;
+    evt.motion.x = UnpackCoordinate(x);
+    evt.motion.y = UnpackCoordinate(y);
+    evt.motion.xrel = UnpackCoordinate(xrel);
+    evt.motion.yrel = UnpackCoordinate(yrel);
+    return true;
+  case RECORD_MOUSE_BUTTON_DOWN:
+  case RECORD_MOUSE_BUTTON_UP:
+    if (Get8(touch) == false || Get8(button) == false || Get8(clicks) == false || Get16(x) == false ||
+      Get16(y) == false)
+    {
+      return false;
+    }
+
+    evt.type = (type == RECORD_MOUSE_BUTTON_DOWN) ? SDL_MOUSEBUTTONDOWN : SDL_MOUSEBUTTONUP;
+    evt.button.state = (type == RECORD_MOUSE_BUTTON_DOWN) ? SDL_PRESSED : SDL_RELEASED;
+    evt.button.which = touch ? SDL_TOUCH_MOUSEID : 0;
+    evt.button.button = button;
+    evt.button.clicks = clicks;
+    evt.button.x = UnpackCoordinate(x);
+    evt.button.y = UnpackCoordinate(y);
+    return true;
+  case RECORD_MOUSE_WHEEL:
+    if (Get8(touch) == false || Get16(x) == false || Get16(y) == false)
+    {
+      return false;
+    }
+
+    evt.type = SDL_MOUSEWHEEL;
+    evt.wheel.which = touch ? SDL_TOUCH_MOUSEID : 0;
+    evt.wheel.x = UnpackCoordinate(x);
+    evt.wheel.y = UnpackCoordinate(y);
+    return true;
+  case RECORD_QUIT:
+    evt.type = SDL_QUIT;
+    return true;
+  default:
+    // A record type this build doesn't know, the rest of the log can't be trusted.
+    return false;
+  }
+}
+
+bool InputRecorder::IsRecordable(const SDL_Event &evt)
+{
+  switch (evt.type)
+  {
+  case SDL_KEYDOWN:
+  case SDL_KEYUP:
+  case SDL_MOUSEMOTION:
+  case SDL_MOUSEBUTTONDOWN:
+  case SDL_MOUSEBUTTONUP:
+  case SDL_MOUSEWHEEL:
+  case SDL_QUIT:
+    return true;
+  default:
+    return false;
+  }
+}
+
+int InputRecorder::GetTickEventCount() const
+{
+  return (int)_tickEvents.size();
+}
+
+const SDL_Event& InputRecorder::GetTickEvent(int index) const
+{
+  return _tickEvents[index];
+}
+
+unsigned int InputRecorder::GetTickIndex() const
+{
+  return _tickIndex;
+}
+
+// The log is little endian whatever the platform.
+void InputRecorder::Put8(Uint8 value)
+{
+  _tickBytes.push_back(value);
+}
+
+void InputRecorder::Put16(Uint16 value)
+{
+  Put8((Uint8)(value & 0xFF));
+  Put8((Uint8)(value >> 8));
+}
+
+void InputRecorder::Put32(Uint32 value)
+{
+  Put16((Uint16)(value & 0xFFFF));
+  Put16((Uint16)(value >> 16));
+}
+
+bool InputRecorder::Get8(Uint8 &value)
+{
+  return fread(&value, 1, 1, _file) == 1;
+}
+
+bool InputRecorder::Get16(Uint16 &value)
+{
+  Uint8 low, high;
+  if (Get8(low) == false || Get8(high) == false)
+  {
+    return false;
+  }
+
+  value = (Uint16)(low | (high << 8));
+  return true;
+}
+
+bool InputRecorder::Get32(Uint32 &value)
+{
+  Uint16 low, high;
+  if (Get16(low) == false || Get16(high) == false)
+  {
+    return false;
+  }
+
+  value = (Uint32)low | ((Uint32)high << 16);
+  return true;
+}
\ No newline at end of file
@@ -0,0 +1,144 @@
+/**
+ * \class InputRecorder
+ * \brief Records the random seed and every input event the engine processes, tick by tick, and plays them back.
+ *
+ * A recording is a small binary log: a header holding the seed, then one block per engine tick holding the
+ * tick's delta time and its events. Only the events the engine acts on are logged (keys, mouse motion, buttons and
+ * wheel, and quit), each as a small little endian record of the fields that matter, eg. 10 bytes for a key and
+ * 11 for a mouse motion. Window, drop and user events are left out, they point at memory or windows that won't
+ * exist on replay. Replaying a log through the same build feeds the game the exact same ticks, so a session can be
+ * re-run as a benchmark or a regression test.
+ */
+
+#pragma once
+#include <SDL_events.h>
+#include <stdio.h>
+#include <vector>
+
+class InputRecorder
+{
+public:
+  enum Mode
+  {
+    MODE_IDLE,
+    MODE_RECORDING,
+    MODE_REPLAYING
+  };
+
+  /**
+  * \fn InputRecorder::InputRecorder()
+  * \brief Creates a recorder that is neither recording nor replaying.
+  */
+  InputRecorder();
+
+  /**
+  * \fn InputRecorder::~InputRecorder()
+  * \brief Stops, flushing any recording to disk.
+  */
+  ~InputRecorder();
+
+  /**
+  * \fn bool InputRecorder::StartRecording(const char *path, Uint32 seed)
+  * \brief Starts a new log.
+  * \param path The file to write, replaced if it exists.
+  * \param seed The seed the game's random numbers are generated from.
+  * \return Whether or not the file could be created.
+  */
+  bool StartRecording(const char *path, Uint32 seed);
+
+  /**
+  * \fn bool InputRecorder::StartReplay(const char *path)
+  * \brief Opens a log for playback. The seed is available from GetSeed straight away.
+  * \param path The file to read.
+  * \return Whether or not the file could be opened and is a log of this version.
+  */
+  bool StartReplay(const char *path);
+
+  /**
+  * \fn void InputRecorder::Stop()
+  * \brief Closes the log.
+  */
+  void Stop();
+
+  Mode GetMode() const;
+  Uint32 GetSeed() const;
+
+  /**
+  * \fn void InputRecorder::BeginTick(float dt)
+  * \brief Starts recording a tick.
+  * \param dt The delta time the tick runs with.
+  */
+  void BeginTick(float dt);
+
+  /**
+  * \fn void InputRecorder::RecordEvent(const SDL_Event &evt)
+  * \brief Adds a processed event to the tick being recorded. Events of other types than the ones logged are ignored.
+  */
+  void RecordEvent(const SDL_Event &evt);
+
+  /**
+  * \fn void InputRecorder::EndTick()
+  * \brief Writes the tick being recorded to the log.
+  */
+  void EndTick();
+
+  /**
+  * \fn bool InputRecorder::ReadTick(float &dt)
+  * \brief Loads the next tick of the log being replayed.
+  * \param dt Receives the delta time the tick was recorded with.
+  * \return false once the log has no ticks left.
+  */
+  bool ReadTick(float &dt);
+
+  /**
+  * \fn int InputRecorder::GetTickEventCount() const
+  * \brief Gets the number of events of the tick last loaded by ReadTick.
+  */
+  int GetTickEventCount() const;
+
+  /**
+  * \fn const SDL_Event& InputRecorder::GetTickEvent(int index) const
+  * \brief Gets an event of the tick last loaded by ReadTick, in the order it was processed.
+  */
+  const SDL_Event& GetTickEvent(int index) const;
+
+  /**
+  * \fn unsigned int InputRecorder::GetTickIndex() const
+  * \brief Gets the number of ticks recorded or replayed so far.
+  */
+  unsigned int GetTickIndex() const;
+
+protected:
+  enum RecordType
+  {
+    RECORD_KEY_DOWN = 1,
+    RECORD_KEY_UP = 2,
+    RECORD_MOUSE_MOTION = 3,
+    RECORD_MOUSE_BUTTON_DOWN = 4,
+    RECORD_MOUSE_BUTTON_UP = 5,
+    RECORD_MOUSE_WHEEL = 6,
+    RECORD_QUIT = 7
+  };
+
+  static bool IsRecordable(const SDL_Event &evt);
+
+  void WriteTick();
+  bool ReadEvent(Uint8 type, SDL_Event &evt);
+
+  void Put8(Uint8 value);
+  void Put16(Uint16 value);
+  void Put32(Uint32 value);
+  bool Get8(Uint8 &value);
+  bool Get16(Uint16 &value);
+  bool Get32(Uint32 &value);
+
+  FILE *_file;
+  Mode _mode;
+  Uint32 _seed;
+  unsigned int _tickIndex;
+
+  // The tick being recorded or replayed. Recorded ticks are encoded into _tickBytes and written with a single fwrite.
+  float _tickDeltaTime;
+  std::vector<SDL_Event> _tickEvents;
+  std::vector<Uint8> _tickBytes;
+};
\ No newline at end of file
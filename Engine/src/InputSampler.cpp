@@ -0,0 +1,149 @@
+#include "InputSampler.h"
+#include <SDL_timer.h>
+#include <vector>
+
+InputSampler::InputSampler() :
+_head(0),
+_count(0),
+_producerThread(0),
+_isSampling(false),
+_isOverflowing(false),
+_overflowCount(0),
+_previousFilter(nullptr),
+_previousUserData(nullptr)
+{
+}
+
+InputSampler::~InputSampler()
+{
+  Stop();
+}
+
+bool InputSampler::Start()
+{
+  if (_isSampling)
+  {
+    return true;
+  }
+
+  if (SDL_GetEventFilter(&_previousFilter, &_previousUserData) == SDL_FALSE)
+  {
+    _previousFilter = nullptr;
+    _previousUserData = nullptr;
+  }
+
+  _producerThread = SDL_ThreadID();
+  _isOverflowing = false;
+  _isSampling = true;
+  SetFilter(OnEvent, this, nullptr, 0);
+  return true;
+}
+
+void InputSampler::Stop()
+{
+  if (_isSampling == false)
+  {
+    return;
+  }
+
+  _isSampling = false;
+
+  // The sampled events are older than anything SDL queued since, so they go back in first.
+  std::vector<TimedEvent> sampled;
+  TimedEvent timedEvent;
+  while (Pop(timedEvent))
+  {
+    sampled.push_back(timedEvent);
+  }
+
+  SetFilter(_previousFilter, _previousUserData, sampled.empty() ? nullptr : &sampled[0], (int)sampled.size());
+}
+
+void InputSampler::Pump()
+{
+  if (_isSampling)
+  {
+    SDL_PumpEvents();
+  }
+}
+
+bool InputSampler::Pop(TimedEvent &timedEvent)
+{
+  if (_count == 0)
+  {
+    return false;
+  }
+
+  timedEvent = _queue[_head];
+  _head = (_head + 1) % kQueueCapacity;
+  _count--;
+  return true;
+}
+
+void InputSampler::ResumeAfterOverflow()
+{
+  _isOverflowing = false;
+}
+
+unsigned int InputSampler::GetOverflowCount() const
+{
+  return _overflowCount;
+}
+
+int SDLCALL InputSampler::OnEvent(void *userData, SDL_Event *evt)
+{
+  InputSampler *sampler = static_cast<InputSampler *>(userData);
+
+  // The filter that was there before still gets the first say.
+  if (sampler->_previousFilter != nullptr && sampler->_previousFilter(sampler->_previousUserData, evt) == 0)
+  {
+    return 0;
+  }
+
+  if (sampler->_isSampling == false || SDL_ThreadID() != sampler->_producerThread)
+  {
+    return 1;
+  }
+
+  if (sampler->_isOverflowing == false)
+  {
+    // Returning 0 takes the event out of SDL's queue, the sampler delivers it instead.
+    if (sampler->_count < kQueueCapacity)
+    {
+      TimedEvent &timedEvent = sampler->_queue[(sampler->_head + sampler->_count) % kQueueCapacity];
+      timedEvent.event = *evt;
+      timedEvent.timestamp = SDL_GetPerformanceCounter();
+      sampler->_count++;
+      return 0;
+    }
+
+    sampler->_isOverflowing = true;
+  }
+
+  sampler->_overflowCount++;
+  return 1;
+}
+
+void InputSampler::SetFilter(SDL_EventFilter filter, void *userData, TimedEvent *firstEvents, int firstCount)
+{
+  // Take the queue out before SDL_SetEventFilter flushes it. Adding events back with SDL_PeepEvents skips the
+  // filter, so nothing is captured twice.
+  std::vector<SDL_Event> pending;
+  SDL_Event events[64];
+  int count;
+  while ((count = SDL_PeepEvents(events, 64, SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT)) > 0)
+  {
+    pending.insert(pending.end(), events, events + count);
+  }
+
+  SDL_SetEventFilter(filter, userData);
+
+  for (int i = 0; i < firstCount; i++)
+  {
+    SDL_PeepEvents(&firstEvents[i].event, 1, SDL_ADDEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+  }
+  if (pending.empty() == false)
+  {
+    SDL_PeepEvents(&pending[0], (int)pending.size(), SDL_ADDEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+  }
+}
@@ -0,0 +1,115 @@
+/**
+ * \class InputSampler
+ * \brief Stamps SDL events with the high resolution clock when the game thread pumps them and queues them for it.
+ *
+ * Events are captured by an SDL event filter, which runs on whichever thread pumps SDL. SDL only allows pumping on
+ * the thread that created the window (Windows, X11 and Mac OS X all deliver window input there), so the game thread
+ * pumps, and it can pump more than once per frame to tighten the stamps, eg. before a blocking buffer swap. The
+ * stamp is therefore the time of the pump that delivered the event, not the time the OS saw it. As the queue is
+ * only ever touched by the game thread it is a plain ring buffer.
+ * Captured events are taken out of SDL's queue. Anything else, eg. events pushed from other threads or arriving
+ * while the queue is full, stays in SDL's queue for the game thread to drain after popping the sampled ones.
+ */
+
+#pragma once
+#include <SDL_events.h>
+#include <SDL_thread.h>
+#include <atomic>
+
+struct TimedEvent
+{
+  SDL_Event event;
+
+  // SDL_GetPerformanceCounter() when the event was pumped.
+  Uint64 timestamp;
+};
+
+class InputSampler
+{
+public:
+  /**
+  * \fn InputSampler::InputSampler()
+  * \brief Creates a sampler that isn't sampling yet.
+  */
+  InputSampler();
+
+  /**
+  * \fn InputSampler::~InputSampler()
+  * \brief Stops sampling.
+  */
+  ~InputSampler();
+
+  /**
+  * \fn bool InputSampler::Start()
+  * \brief Starts capturing the events pumped on the calling thread. Call from the game thread, after the video
+  * subsystem is initialized. Events already in SDL's queue stay there.
+  * \return Whether or not sampling started.
+  */
+  bool Start();
+
+  /**
+  * \fn void InputSampler::Stop()
+  * \brief Stops capturing events and hands the ones not popped yet back to SDL's queue, ahead of what is there.
+  */
+  void Stop();
+
+  /**
+  * \fn void InputSampler::Pump()
+  * \brief Pumps SDL on the calling thread, which must be the one that called Start.
+  */
+  void Pump();
+
+  /**
+  * \fn bool InputSampler::Pop(TimedEvent &timedEvent)
+  * \brief Takes the oldest sampled event. Game thread only.
+  * \param timedEvent Receives the event and its timestamp.
+  * \return false if there are no events waiting.
+  */
+  bool Pop(TimedEvent &timedEvent);
+
+  /**
+  * \fn void InputSampler::ResumeAfterOverflow()
+  * \brief Starts capturing again after the queue filled up. Call after popping every sampled event and before
+  * draining SDL's queue, so the events that went to SDL's queue meanwhile are handled before newer sampled ones.
+  */
+  void ResumeAfterOverflow();
+
+  /**
+  * \fn unsigned int InputSampler::GetOverflowCount() const
+  * \brief Gets the number of events that went through SDL's queue unstamped because the game thread fell too far behind.
+  */
+  unsigned int GetOverflowCount() const;
+
+protected:
+  static int SDLCALL OnEvent(void *userData, SDL_Event *evt);
+
+  /**
+  * \fn void InputSampler::SetFilter(SDL_EventFilter filter, void *userData, TimedEvent *firstEvents, int firstCount)
+  * \brief Replaces SDL's event filter without losing the events in its queue, which SDL_SetEventFilter flushes.
+  * \param firstEvents Events to put in the queue ahead of the ones already there, may be NULL.
+  */
+  static void SetFilter(SDL_EventFilter filter, void *userData, TimedEvent *firstEvents, int firstCount);
+
+  // Roughly a second of heavy mouse input.
+  static const unsigned int kQueueCapacity = 1024;
+
+  // Ring buffer of the sampled events, _count of them from _head on.
+  TimedEvent _queue[kQueueCapacity];
+  unsigned int _head;
+  unsigned int _count;
+
+  // The only thread whose events get captured, the one that called Start. Anything pushed from elsewhere (timers,
+  // other threads) is left to SDL's own queue, so only that thread touches the ring buffer. The filter still runs
+  // on the pushing threads, so the two values it reads there are atomic.
+  std::atomic<SDL_threadID> _producerThread;
+  std::atomic<bool> _isSampling;
+
+  // Set when the queue filled up, every event then stays in SDL's queue until ResumeAfterOverflow so none is
+  // handled ahead of an older one.
+  bool _isOverflowing;
+  unsigned int _overflowCount;
+
+  // The filter that was set before Start, events the sampler doesn't capture still go through it.
+  SDL_EventFilter _previousFilter;
+  void *_previousUserData;
+};
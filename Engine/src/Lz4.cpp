@@ -0,0 +1,225 @@
+#include "Lz4.h"
+#include <string.h>
+
+// Limits from the LZ4 block format.
+static const int kMinMatch = 4;
+static const int kLastLiterals = 5;
+static const int kMatchFindLimit = 12;
+static const int kMaxOffset = 65535;
+
+static const int kHashBits = 12;
+
+static Uint32 Read32(const Uint8 *p)
+{
+  Uint32 value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+static int Hash(Uint32 sequence)
+{
+  return (int)((sequence * 2654435761u) >> (32 - kHashBits));
+}
+
+// Writes the extra bytes of a length that didn't fit in its token nibble.
+static bool WriteLength(int length, Uint8 *&out, const Uint8 *end)
+{
+  for (; length >= 255; length -= 255)
+  {
+    if (out >= end)
+    {
+      return false;
+    }
+    *out++ = 255;
+  }
+
+  if (out >= end)
+  {
+    return false;
+  }
+  *out++ = (Uint8)length;
+  return true;
+}
+
+int Lz4CompressBound(int sourceSize)
+{
+  return sourceSize + sourceSize / 255 + 16;
+}
+
+int Lz4Compress(const Uint8 *source, int sourceSize, Uint8 *destination, int destinationCapacity)
+{
+  int table[1 << kHashBits];
+  for (int i = 0; i < (1 << kHashBits); i++)
+  {
+    table[i] = -1;
+  }
+
+  Uint8 *out = destination;
+  const Uint8 *outEnd = destination + destinationCapacity;
+
+  int anchor = 0;
+  int position = 0;
+  int matchEndLimit = sourceSize - kLastLiterals;
+
+  while (position + kMatchFindLimit <= sourceSize)
+  {
+    Uint32 sequence = Read32(source + position);
+    int hash = Hash(sequence);
+    int candidate = table[hash];
+    table[hash] = position;
+
+    if (candidate < 0 || position - candidate > kMaxOffset || Read32(source + candidate) != sequence)
+    {
+      position++;
+      continue;
+    }
+
+    int matchLength = kMinMatch;
+    while (position + matchLength < matchEndLimit && source[candidate + matchLength] == source[position + matchLength])
+    {
+      matchLength++;
+    }
+
+    // Token, literals, offset, then whatever of the match length didn't fit the token.
+    int literalLength = position - anchor;
+    if (out >= outEnd)
+    {
+      return 0;
+    }
+
+    Uint8 *token = out++;
+    *token = (Uint8)(((literalLength < 15) ? literalLength : 15) << 4);
+    if (literalLength >= 15 && WriteLength(literalLength - 15, out, outEnd) == false)
+    {
+      return 0;
+    }
+
+    if (out + literalLength + 2 > outEnd)
+    {
+      return 0;
+    }
+    memcpy(out, source + anchor, literalLength);
+    out += literalLength;
+
+    int offset = position - candidate;
+    *out++ = (Uint8)(offset & 0xFF);
+    *out++ = (Uint8)(offset >> 8);
+
+    int extraMatch = matchLength - kMinMatch;
+    *token |= (Uint8)((extraMatch < 15) ? extraMatch : 15);
+    if (extraMatch >= 15 && WriteLength(extraMatch - 15, out, outEnd) == false)
+    {
+      return 0;
+    }
+
+    position += matchLength;
+    anchor = position;
+  }
+
+  // The block always ends on literals.
+  int literalLength = sourceSize - anchor;
+  if (out >= outEnd)
+  {
+    return 0;
+  }
+
+  Uint8 *token = out++;
+  *token = (Uint8)(((literalLength < 15) ? literalLength : 15) << 4);
+  if (literalLength >= 15 && WriteLength(literalLength - 15, out, outEnd) == false)
+  {
+    return 0;
+  }
+
+  if (out + literalLength > outEnd)
+  {
+    return 0;
+  }
+  memcpy(out, source + anchor, literalLength);
+  out += literalLength;
+
+  return (int)(out - destination);
+}
+
+int Lz4Decompress(const Uint8 *source, int sourceSize, Uint8 *destination, int destinationSize)
+{
+  const Uint8 *in = source;
+  const Uint8 *inEnd = source + sourceSize;
+  Uint8 *out = destination;
+  Uint8 *outEnd = destination + destinationSize;
+
+  while (in < inEnd)
+  {
+    Uint8 token = *in++;
+
+    int literalLength = token >> 4;
+    if (literalLength == 15)
+    {
+      Uint8 extra;
+      do
+      {
+        if (in >= inEnd)
+        {
+          return -1;
+        }
+        extra = *in++;
+        literalLength += extra;
+      } while (extra == 255);
+    }
+
+    if (literalLength > inEnd - in || literalLength > outEnd - out)
+    {
+      return -1;
+    }
+    memcpy(out, in, literalLength);
+    in += literalLength;
+    out += literalLength;
+
+    // The last sequence has no match.
+    if (in == inEnd)
+    {
+      break;
+    }
+
+    if (inEnd - in < 2)
+    {
+      return -1;
+    }
+    int offset = in[0] | (in[1] << 8);
+    in += 2;
+    if (offset == 0 || offset > out - destination)
+    {
+      return -1;
+    }
+
+    int matchLength = token & 15;
+    if (matchLength == 15)
+    {
+      Uint8 extra;
+      do
+      {
+        if (in >= inEnd)
+        {
+          return -1;
+        }
+        extra = *in++;
+        matchLength += extra;
+      } while (extra == 255);
+    }
+    matchLength += kMinMatch;
+
+    if (matchLength > outEnd - out)
+    {
+      return -1;
+    }
+
+    // Byte by byte: the match may overlap the bytes it is producing.
+    const Uint8 *match = out - offset;
+    for (int i = 0; i < matchLength; i++)
+    {
+      out[i] = match[i];
+    }
+    out += matchLength;
+  }
+
+  return (int)(out - destination);
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+/**
+ * Lz4.h
+ * Purpose: Compression and decompression of raw LZ4 blocks (no frame header), as stored in packed archives.
+ *
+ * The compressor is a plain greedy single-pass matcher: it favours simple code and fast decompression over
+ * ratio, which suits assets that are packed once offline and unpacked at every launch.
+ */
+
+#pragma once
+#include <SDL_stdinc.h>
+
+/**
+ * @return The most bytes compressing sourceSize bytes can take, for sizing the destination buffer.
+ */
+int Lz4CompressBound(int sourceSize);
+
+/**
+ * Compresses a block.
+ * @param source The bytes to compress.
+ * @param sourceSize The number of bytes to compress.
+ * @param destination Receives the compressed block.
+ * @param destinationCapacity The size of destination, Lz4CompressBound(sourceSize) always fits.
+ * @return The size of the compressed block, 0 if it didn't fit.
+ */
+int Lz4Compress(const Uint8 *source, int sourceSize, Uint8 *destination, int destinationCapacity);
+
+/**
+ * Decompresses a block, checking every length and offset against the buffers.
+ * @param source The compressed block.
+ * @param sourceSize The size of the compressed block.
+ * @param destination Receives the decompressed bytes.
+ * @param destinationSize The size of destination.
+ * @return The number of bytes decompressed, -1 if the block is corrupt or doesn't fit.
+ */
+int Lz4Decompress(const Uint8 *source, int sourceSize, Uint8 *destination, int destinationSize);
\ No newline at end of file
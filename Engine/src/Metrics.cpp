@@ -0,0 +1,38 @@
+#include "Metrics.h"
+
+CsvMetricsSink::CsvMetricsSink(const char *path) : _frame(0)
+{
+  _file = fopen(path, "w");
+  if (_file != nullptr)
+  {
+    fprintf(_file, "frame,name,value\n");
+  }
+}
+
+CsvMetricsSink::~CsvMetricsSink()
+{
+  if (_file != nullptr)
+  {
+    fclose(_file);
+  }
+}
+
+bool CsvMetricsSink::IsOpen() const
+{
+  return _file != nullptr;
+}
+
+void CsvMetricsSink::BeginFrame(unsigned int frame)
+{
+  _frame = frame;
+}
+
+void CsvMetricsSink::Record(const char *name, double value)
+{
+  if (_file != nullptr)
+  {
+    fprintf(_file, "%u,%s,%g\n", _frame, name, value);
+  }
+}
+
+void CsvMetricsSink::EndFrame() { }
\ No newline at end of file
@@ -0,0 +1,64 @@
+/**
+ * \class MetricsSink
+ * \brief Receives named per-frame measurements from the engine, eg. render statistics.
+ */
+
+#pragma once
+#include <stdio.h>
+
+class MetricsSink
+{
+public:
+  virtual ~MetricsSink() { }
+
+  /**
+  * \fn void MetricsSink::BeginFrame(unsigned int frame)
+  * \brief Called before any value of the given frame is recorded.
+  * \param frame The index of the frame being reported.
+  */
+  virtual void BeginFrame(unsigned int frame) = 0;
+
+  /**
+  * \fn void MetricsSink::Record(const char *name, double value)
+  * \brief Records a single named value for the current frame.
+  * \param name The name of the metric. Must stay valid for the duration of the call.
+  * \param value The measured value.
+  */
+  virtual void Record(const char *name, double value) = 0;
+
+  /**
+  * \fn void MetricsSink::EndFrame()
+  * \brief Called once every value of the current frame has been recorded.
+  */
+  virtual void EndFrame() = 0;
+};
+
+/**
+ * \class CsvMetricsSink
+ * \brief Writes every recorded metric as a "frame,name,value" line, for automated perf runs.
+ */
+class CsvMetricsSink : public MetricsSink
+{
+public:
+  /**
+  * \fn CsvMetricsSink::CsvMetricsSink(const char *path)
+  * \brief Opens (and truncates) the given file for writing.
+  * \param path The path of the CSV file to write.
+  */
+  CsvMetricsSink(const char *path);
+  ~CsvMetricsSink();
+
+  /**
+  * \fn bool CsvMetricsSink::IsOpen() const
+  * \brief Gets whether or not the output file could be opened.
+  */
+  bool IsOpen() const;
+
+  void BeginFrame(unsigned int frame);
+  void Record(const char *name, double value);
+  void EndFrame();
+
+protected:
+  FILE *_file;
+  unsigned int _frame;
+};
\ No newline at end of file
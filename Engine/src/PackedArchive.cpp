@@ -0,0 +1,351 @@
+#include "PackedArchive.h"
+#include "Lz4.h"
+#include "ResourceCache.h"
+#include <SDL_endian.h>
+#include <SDL_rwops.h>
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// The header and index are read in place, which assumes a little endian machine like the ones the game ships on.
+#if SDL_BYTEORDER != SDL_LIL_ENDIAN
+#error PackedArchive reads its index in place and only supports little endian platforms
+#endif
+
+PackedArchive::PackedArchive() :
+_data(nullptr),
+_size(0),
+_header(nullptr),
+_entries(nullptr),
+_file(nullptr),
+_mapping(nullptr)
+{
+}
+
+PackedArchive::~PackedArchive()
+{
+  Close();
+}
+
+bool PackedArchive::Open(const char *path)
+{
+  Close();
+
+#ifdef _WIN32
+  HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, NULL);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    return false;
+  }
+
+  LARGE_INTEGER fileSize;
+  GetFileSizeEx(file, &fileSize);
+  HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (mapping == NULL)
+  {
+    CloseHandle(file);
+    return false;
+  }
+
+  _data = (const Uint8 *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (_data == nullptr)
+  {
+    CloseHandle(mapping);
+    CloseHandle(file);
+    return false;
+  }
+
+  _file = file;
+  _mapping = mapping;
+  _size = (size_t)fileSize.QuadPart;
+#else
+  int file = open(path, O_RDONLY);
+  if (file < 0)
+  {
+    return false;
+  }
+
+  struct stat info;
+  if (fstat(file, &info) != 0 || info.st_size == 0)
+  {
+    close(file);
+    return false;
+  }
+
+  void *data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+  close(file);
+  if (data == MAP_FAILED)
+  {
+    return false;
+  }
+
+  _data = (const Uint8 *)data;
+  _size = (size_t)info.st_size;
+#endif
+
+  // Check everything the lookups rely on once, here.
+  _header = (const ArchiveHeader *)_data;
+  bool isValid = _size >= sizeof(ArchiveHeader) && _header->magic == kArchiveMagic && _header->version == kArchiveVersion &&
+    sizeof(ArchiveHeader) + (size_t)_header->entryCount * sizeof(ArchiveEntry) <= _header->pathsOffset &&
+    _header->pathsOffset <= _size;
+
+  if (isValid)
+  {
+    _entries = (const ArchiveEntry *)(_data + sizeof(ArchiveHeader));
+    for (Uint32 i = 0; i < _header->entryCount && isValid; i++)
+    {
+      const ArchiveEntry &entry = _entries[i];
+      // Stored entries are handed out as entry.size bytes straight from the mapping, so both sizes must agree.
+      isValid = entry.pathOffset < _size && entry.dataOffset <= _size && entry.storedSize <= _size - entry.dataOffset &&
+        ((entry.flags & ARCHIVE_ENTRY_LZ4) != 0 || entry.size == entry.storedSize) &&
+        memchr(_data + entry.pathOffset, '\0', _size - entry.pathOffset) != nullptr &&
+        (i == 0 || _entries[i - 1].pathHash <= entry.pathHash);
+    }
+  }
+
+  if (isValid == false)
+  {
+    printf("PackedArchive: %s is not a valid archive\n", path);
+    Close();
+    return false;
+  }
+
+  return true;
+}
+
+void PackedArchive::Close()
+{
+  if (_data == nullptr)
+  {
+    return;
+  }
+
+#ifdef _WIN32
+  UnmapViewOfFile(_data);
+  CloseHandle((HANDLE)_mapping);
+  CloseHandle((HANDLE)_file);
+#else
+  munmap((void *)_data, _size);
+#endif
+
+  _data = nullptr;
+  _size = 0;
+  _header = nullptr;
+  _entries = nullptr;
+  _file = nullptr;
+  _mapping = nullptr;
+}
+
+bool PackedArchive::IsOpen() const
+{
+  return _data != nullptr;
+}
+
+const ArchiveEntry* PackedArchive::Find(const char *path) const
+{
+  if (_data == nullptr)
+  {
+    return nullptr;
+  }
+
+  Uint32 hash = HashResourcePath(path);
+
+  // First entry with the hash, then walk the (rare) entries sharing it.
+  const ArchiveEntry *end = _entries + _header->entryCount;
+  const ArchiveEntry *entry = _entries;
+  Uint32 count = _header->entryCount;
+  while (count > 0)
+  {
+    Uint32 half = count / 2;
+    if (entry[half].pathHash < hash)
+    {
+      entry += half + 1;
+      count -= half + 1;
+    }
+    else
+    {
+      count = half;
+    }
+  }
+
+  for (; entry != end && entry->pathHash == hash; entry++)
+  {
+    if (strcmp((const char *)_data + entry->pathOffset, path) == 0)
+    {
+      return entry;
+    }
+  }
+
+  return nullptr;
+}
+
+const Uint8* PackedArchive::GetData(const ArchiveEntry *entry, std::vector<Uint8> &buffer) const
+{
+  const Uint8 *stored = _data + entry->dataOffset;
+  if ((entry->flags & ARCHIVE_ENTRY_LZ4) == 0)
+  {
+    return stored;
+  }
+
+  buffer.resize(entry->size);
+  if (Lz4Decompress(stored, (int)entry->storedSize, buffer.empty() ? nullptr : &buffer[0], (int)entry->size) != (int)entry->size)
+  {
+    return nullptr;
+  }
+
+  return buffer.empty() ? stored : &buffer[0];
+}
+
+// Closes a memory stream over a buffer decompressed by OpenRW, freeing the buffer with it.
+static int SDLCALL CloseDecompressedRW(SDL_RWops *context)
+{
+  SDL_free(context->hidden.mem.base);
+  SDL_FreeRW(context);
+  return 0;
+}
+
+SDL_RWops* PackedArchive::OpenRW(const char *path) const
+{
+  const ArchiveEntry *entry = Find(path);
+  if (entry == nullptr)
+  {
+    return nullptr;
+  }
+
+  const Uint8 *stored = _data + entry->dataOffset;
+  if ((entry->flags & ARCHIVE_ENTRY_LZ4) == 0)
+  {
+    return SDL_RWFromConstMem(stored, (int)entry->size);
+  }
+
+  Uint8 *buffer = (Uint8 *)SDL_malloc(entry->size > 0 ? entry->size : 1);
+  if (buffer == nullptr || Lz4Decompress(stored, (int)entry->storedSize, buffer, (int)entry->size) != (int)entry->size)
+  {
+    SDL_free(buffer);
+    SDL_SetError("PackedArchive: %s is corrupt", path);
+    return nullptr;
+  }
+
+  SDL_RWops *context = SDL_RWFromConstMem(buffer, (int)entry->size);
+  if (context == nullptr)
+  {
+    SDL_free(buffer);
+    return nullptr;
+  }
+
+  context->close = CloseDecompressedRW;
+  return context;
+}
+
+void PackedArchiveWriter::Add(const char *path, const void *data, size_t size, bool compress)
+{
+  PendingEntry entry;
+  entry.path = path;
+  entry.pathHash = HashResourcePath(path);
+  entry.size = (Uint32)size;
+  entry.flags = 0;
+
+  const Uint8 *bytes = (const Uint8 *)data;
+  if (compress && size > 0)
+  {
+    entry.bytes.resize(Lz4CompressBound((int)size));
+    int compressedSize = Lz4Compress(bytes, (int)size, &entry.bytes[0], (int)entry.bytes.size());
+    if (compressedSize > 0 && (size_t)compressedSize <= size - size / 8)
+    {
+      entry.bytes.resize(compressedSize);
+      entry.flags = ARCHIVE_ENTRY_LZ4;
+    }
+  }
+
+  if (entry.flags == 0)
+  {
+    entry.bytes.assign(bytes, bytes + size);
+  }
+
+  _entries.push_back(entry);
+}
+
+bool PackedArchiveWriter::CompareHash(const PendingEntry *first, const PendingEntry *second)
+{
+  return first->pathHash < second->pathHash;
+}
+
+bool PackedArchiveWriter::Write(const char *path) const
+{
+  std::vector<const PendingEntry *> sorted;
+  for (auto itr = _entries.begin(); itr != _entries.end(); itr++)
+  {
+    sorted.push_back(&*itr);
+  }
+  std::stable_sort(sorted.begin(), sorted.end(), CompareHash);
+
+  ArchiveHeader header;
+  header.magic = kArchiveMagic;
+  header.version = kArchiveVersion;
+  header.reserved = 0;
+  header.entryCount = (Uint32)sorted.size();
+  header.pathsOffset = (Uint32)(sizeof(ArchiveHeader) + sorted.size() * sizeof(ArchiveEntry));
+
+  // Lay out the paths, then the aligned data.
+  std::vector<ArchiveEntry> index(sorted.size());
+  Uint32 offset = header.pathsOffset;
+  for (size_t i = 0; i < sorted.size(); i++)
+  {
+    index[i].pathOffset = offset;
+    offset += (Uint32)sorted[i]->path.size() + 1;
+  }
+
+  for (size_t i = 0; i < sorted.size(); i++)
+  {
+    offset = (offset + kArchiveAlignment - 1) & ~(kArchiveAlignment - 1);
+    index[i].pathHash = sorted[i]->pathHash;
+    index[i].dataOffset = offset;
+    index[i].storedSize = (Uint32)sorted[i]->bytes.size();
+    index[i].size = sorted[i]->size;
+    index[i].flags = sorted[i]->flags;
+    offset += index[i].storedSize;
+  }
+
+  FILE *file = fopen(path, "wb");
+  if (file == nullptr)
+  {
+    printf("PackedArchiveWriter: could not create %s\n", path);
+    return false;
+  }
+
+  fwrite(&header, sizeof(header), 1, file);
+  if (index.empty() == false)
+  {
+    fwrite(&index[0], sizeof(ArchiveEntry), index.size(), file);
+  }
+
+  for (size_t i = 0; i < sorted.size(); i++)
+  {
+    fwrite(sorted[i]->path.c_str(), 1, sorted[i]->path.size() + 1, file);
+  }
+
+  static const Uint8 kZeros[kArchiveAlignment] = { 0 };
+  long written = ftell(file);
+  for (size_t i = 0; i < sorted.size(); i++)
+  {
+    fwrite(kZeros, 1, index[i].dataOffset - written, file);
+    if (sorted[i]->bytes.empty() == false)
+    {
+      fwrite(&sorted[i]->bytes[0], 1, sorted[i]->bytes.size(), file);
+    }
+    written = index[i].dataOffset + index[i].storedSize;
+  }
+
+  bool isWritten = ferror(file) == 0;
+  fclose(file);
+  return isWritten;
+}
\ No newline at end of file
@@ -0,0 +1,152 @@
+/**
+ * \class PackedArchive
+ * \brief A read-only archive of assets, memory-mapped as a whole so loading an asset reads straight from the mapping.
+ *
+ * Layout (little endian):
+ *   ArchiveHeader
+ *   ArchiveEntry[entryCount], sorted by path hash so lookups are a binary search
+ *   the entry paths, each NUL terminated, to tell apart paths whose hashes collide
+ *   the entry data, every entry starting on a kArchiveAlignment boundary
+ * An entry is stored either as-is or as a single LZ4 block. Stored entries are handed out without copying;
+ * compressed entries are decompressed into a buffer owned by the caller.
+ */
+
+#pragma once
+#include <SDL_stdinc.h>
+#include <string>
+#include <vector>
+
+struct SDL_RWops;
+
+static const Uint32 kArchiveMagic = 0x4B504243; // "CBPK"
+static const Uint16 kArchiveVersion = 1;
+static const Uint32 kArchiveAlignment = 16;
+
+enum ArchiveEntryFlags
+{
+  ARCHIVE_ENTRY_LZ4 = 1 << 0
+};
+
+struct ArchiveHeader
+{
+  Uint32 magic;
+  Uint16 version;
+  Uint16 reserved;
+  Uint32 entryCount;
+  Uint32 pathsOffset;
+};
+
+struct ArchiveEntry
+{
+  Uint32 pathHash;
+  Uint32 pathOffset;
+  Uint32 dataOffset;
+  Uint32 storedSize;
+  Uint32 size;
+  Uint32 flags;
+};
+
+class PackedArchive
+{
+public:
+  /**
+  * \fn PackedArchive::PackedArchive()
+  * \brief Creates an archive with nothing mapped.
+  */
+  PackedArchive();
+
+  /**
+  * \fn PackedArchive::~PackedArchive()
+  * \brief Unmaps the archive.
+  */
+  ~PackedArchive();
+
+  /**
+  * \fn bool PackedArchive::Open(const char *path)
+  * \brief Maps an archive file and checks its header and index.
+  * \param path The archive file.
+  * \return Whether or not the file is a valid archive.
+  */
+  bool Open(const char *path);
+
+  /**
+  * \fn void PackedArchive::Close()
+  * \brief Unmaps the archive. Pointers into it become invalid.
+  */
+  void Close();
+
+  bool IsOpen() const;
+
+  /**
+  * \fn const ArchiveEntry* PackedArchive::Find(const char *path) const
+  * \brief Looks an asset up by the path it was packed under, eg. "res/boing2.wav".
+  * \return The entry, NULL if the archive doesn't hold the path.
+  */
+  const ArchiveEntry* Find(const char *path) const;
+
+  /**
+  * \fn const Uint8* PackedArchive::GetData(const ArchiveEntry *entry, std::vector<Uint8> &buffer) const
+  * \brief Gets the bytes of an entry, without copying when it is stored uncompressed.
+  * \param entry An entry of this archive.
+  * \param buffer Receives the bytes of a compressed entry, untouched otherwise.
+  * \return The entry's bytes (entry->size of them), NULL if a compressed entry is corrupt.
+  */
+  const Uint8* GetData(const ArchiveEntry *entry, std::vector<Uint8> &buffer) const;
+
+  /**
+  * \fn SDL_RWops* PackedArchive::OpenRW(const char *path) const
+  * \brief Opens an asset as an SDL_RWops for the SDL loaders (Mix_LoadWAV_RW, IMG_Load_RW...).
+  * Stored entries read straight from the mapping; compressed entries are decompressed into memory that
+  * closing the SDL_RWops frees.
+  * \return The stream, NULL if the archive doesn't hold the path.
+  */
+  SDL_RWops* OpenRW(const char *path) const;
+
+protected:
+  const Uint8 *_data;
+  size_t _size;
+
+  const ArchiveHeader *_header;
+  const ArchiveEntry *_entries;
+
+  // Platform handles of the mapping.
+  void *_file;
+  void *_mapping;
+};
+
+/**
+ * \class PackedArchiveWriter
+ * \brief Builds a PackedArchive file, used by the offline tools.
+ */
+class PackedArchiveWriter
+{
+public:
+  /**
+  * \fn void PackedArchiveWriter::Add(const char *path, const void *data, size_t size, bool compress)
+  * \brief Adds an asset. The data is copied.
+  * \param path The path the asset is looked up by at runtime.
+  * \param compress Whether or not to try LZ4. The entry is only stored compressed if that saves at least an eighth.
+  */
+  void Add(const char *path, const void *data, size_t size, bool compress);
+
+  /**
+  * \fn bool PackedArchiveWriter::Write(const char *path) const
+  * \brief Writes the archive file.
+  * \return Whether or not the file could be written.
+  */
+  bool Write(const char *path) const;
+
+protected:
+  struct PendingEntry
+  {
+    std::string path;
+    Uint32 pathHash;
+    Uint32 size;
+    Uint32 flags;
+    std::vector<Uint8> bytes;
+  };
+
+  static bool CompareHash(const PendingEntry *first, const PendingEntry *second);
+
+  std::vector<PendingEntry> _entries;
+};
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include "Random.h"
+
+// SplitMix64, turns seeds that differ in a single bit into unrelated states.
+static Uint64 SplitMix64(Uint64 &state)
+{
+  Uint64 value = (state += 0x9E3779B97F4A7C15ull);
+  value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+  value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+  return value ^ (value >> 31);
+}
+
+Random::Random()
+{
+  Seed(0, 0);
+}
+
+Random::Random(Uint64 seed, Uint32 stream)
+{
+  Seed(seed, stream);
+}
+
+void Random::Seed(Uint64 seed, Uint32 stream)
+{
+  // The stream goes through its own round first, so nearby seeds on nearby streams don't line up.
+  Uint64 streamState = stream;
+  Uint64 state = seed ^ SplitMix64(streamState);
+  Uint64 low = SplitMix64(state);
+  Uint64 high = SplitMix64(state);
+  _state[0] = (Uint32)low;
+  _state[1] = (Uint32)(low >> 32);
+  _state[2] = (Uint32)high;
+  _state[3] = (Uint32)(high >> 32);
+
+  if ((_state[0] | _state[1] | _state[2] | _state[3]) == 0)
+  {
+    _state[0] = 1;
+  }
+}
+
+Uint32 Random::NextBelow(Uint32 bound)
+{
+  // Lemire's method: the high half of a 32 x 32 bit product is in range, and the low half tells the few biased
+  // draws apart, so there is no division unless the draw lands in the biased part.
+  Uint64 product = (Uint64)Next() * bound;
+  Uint32 low = (Uint32)product;
+  if (low < bound)
+  {
+    Uint32 threshold = (0u - bound) % bound;
+    while (low < threshold)
+    {
+      product = (Uint64)Next() * bound;
+      low = (Uint32)product;
+    }
+  }
+  return (Uint32)(product >> 32);
+}
+
+float Random::NextFloat()
+{
+  // A float holds 24 bits exactly.
+  return (float)(Next() >> 8) * (1.0f / 16777216.0f);
+}
+
+void Random::Fill(Uint32 *values, int count)
+{
+  Uint32 s0 = _state[0];
+  Uint32 s1 = _state[1];
+  Uint32 s2 = _state[2];
+  Uint32 s3 = _state[3];
+  for (int i = 0; i < count; i++)
+  {
+    values[i] = RotateLeft(s1 * 5, 7) * 9;
+    Uint32 shifted = s1 << 9;
+    s2 ^= s0;
+    s3 ^= s1;
+    s1 ^= s2;
+    s0 ^= s3;
+    s2 ^= shifted;
+    s3 = RotateLeft(s3, 11);
+  }
+  _state[0] = s0;
+  _state[1] = s1;
+  _state[2] = s2;
+  _state[3] = s3;
+}
+
+void Random::FillBelow(Uint32 *values, int count, Uint32 bound)
+{
+  for (int i = 0; i < count; i++)
+  {
+    values[i] = NextBelow(bound);
+  }
+}
+
+void Random::Save(Snapshot &snapshot) const
+{
+  snapshot.Write(_state, sizeof(_state));
+}
+
+bool Random::Restore(Snapshot &snapshot)
+{
+  return snapshot.Read(_state, sizeof(_state));
+}
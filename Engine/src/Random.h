@@ -0,0 +1,101 @@
+/**
+ * \class Random
+ * \brief A small, fast pseudo random number generator (xoshiro128**) with no state shared with anything else.
+ *
+ * Every system or thread that needs random numbers owns a Random, so drawing never takes a lock and the numbers a
+ * system draws don't depend on what any other system drew. Generators seeded with the same seed but different stream
+ * numbers give unrelated sequences, so one game seed can feed many systems and many parallel simulations. The state
+ * is 16 bytes that can be copied, saved to a snapshot and restored, so a replay draws the same numbers again.
+ */
+
+#pragma once
+#include "Snapshot.h"
+#include <SDL_stdinc.h>
+
+class Random
+{
+public:
+  /**
+  * \fn Random::Random()
+  * \brief Creates a generator seeded with 0 on stream 0.
+  */
+  Random();
+
+  /**
+  * \fn Random::Random(Uint64 seed, Uint32 stream)
+  * \brief Creates a generator, see Seed.
+  */
+  explicit Random(Uint64 seed, Uint32 stream = 0);
+
+  /**
+  * \fn void Random::Seed(Uint64 seed, Uint32 stream)
+  * \brief Restarts the sequence. Any seed is fine, 0 included.
+  * \param stream Picks one of many unrelated sequences for the same seed, eg. one per system or per worker thread.
+  */
+  void Seed(Uint64 seed, Uint32 stream = 0);
+
+  /**
+  * \fn Uint32 Random::Next()
+  * \brief Draws 32 random bits. Defined here so hot loops can inline it.
+  */
+  Uint32 Next()
+  {
+    Uint32 result = RotateLeft(_state[1] * 5, 7) * 9;
+    Uint32 shifted = _state[1] << 9;
+    _state[2] ^= _state[0];
+    _state[3] ^= _state[1];
+    _state[1] ^= _state[2];
+    _state[0] ^= _state[3];
+    _state[2] ^= shifted;
+    _state[3] = RotateLeft(_state[3], 11);
+    return result;
+  }
+
+  /**
+  * \fn Uint32 Random::NextBelow(Uint32 bound)
+  * \brief Draws a number from 0 to bound - 1, every one equally likely. Cheaper and fairer than Next() % bound.
+  * \return 0 when bound is 0.
+  */
+  Uint32 NextBelow(Uint32 bound);
+
+  /**
+  * \fn float Random::NextFloat()
+  * \brief Draws a number from 0 up to, but not including, 1.
+  */
+  float NextFloat();
+
+  /**
+  * \fn void Random::Fill(Uint32 *values, int count)
+  * \brief Draws count numbers in one go, keeping the state in registers for the whole loop. Each bit of the values
+  * is a fair coin, so eg. 32 coin flips cost one draw.
+  */
+  void Fill(Uint32 *values, int count);
+
+  /**
+  * \fn void Random::FillBelow(Uint32 *values, int count, Uint32 bound)
+  * \brief Draws count numbers from 0 to bound - 1 in one go, see NextBelow.
+  */
+  void FillBelow(Uint32 *values, int count, Uint32 bound);
+
+  /**
+  * \fn void Random::Save(Snapshot &snapshot) const
+  * \brief Appends the state to a snapshot.
+  */
+  void Save(Snapshot &snapshot) const;
+
+  /**
+  * \fn bool Random::Restore(Snapshot &snapshot)
+  * \brief Reads back what Save wrote, the sequence then carries on from where it was saved.
+  * \return false if the snapshot ran out.
+  */
+  bool Restore(Snapshot &snapshot);
+
+protected:
+  static Uint32 RotateLeft(Uint32 value, int bits)
+  {
+    return (value << bits) | (value >> (32 - bits));
+  }
+
+  // Never all 0, the sequence would stay there.
+  Uint32 _state[4];
+};
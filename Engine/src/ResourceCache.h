@@ -0,0 +1,386 @@
+/**
+ * \class ResourceCache
+ * \brief Owns every loaded resource of one type and hands out handles to them.
+ *
+ * Resources are keyed by a hash of their path, so loading the same file twice shares one copy. Paths whose hashes
+ * collide share a bucket and are told apart by comparing the paths themselves. A handle is
+ * a slot index plus the generation of the slot, so a handle kept past its resource's eviction is detected
+ * instead of pointing at whatever reuses the slot. Each resource is reference counted through Acquire and
+ * Release. Unreferenced resources stay cached, least recently used first in line for eviction, until the
+ * memory used by the cache goes over its budget.
+ *
+ * The Traits type says how to load, free and measure a T:
+ *   static T* Load(const char *path);
+ *   static void Free(T *resource);
+ *   static size_t GetSize(const T *resource);
+ */
+
+#pragma once
+#include <SDL_stdinc.h>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Default traits, specialized per resource type (see ResourceManager.h).
+template <typename T>
+struct ResourceTraits;
+
+template <typename T>
+struct ResourceHandle
+{
+  Uint32 index;
+  Uint32 generation;
+
+  ResourceHandle() : index(0), generation(0) { }
+
+  // Generations start at 1, so a default handle never matches a slot.
+  bool IsValid() const { return generation != 0; }
+
+  bool operator==(const ResourceHandle &other) const { return index == other.index && generation == other.generation; }
+  bool operator!=(const ResourceHandle &other) const { return !(*this == other); }
+};
+
+/**
+* \fn Uint32 HashResourcePath(const char *path)
+* \brief 32 bit FNV-1a hash of a path, used as a resource key.
+*/
+inline Uint32 HashResourcePath(const char *path)
+{
+  Uint32 hash = 2166136261u;
+  for (const unsigned char *c = (const unsigned char *)path; *c != '\0'; c++)
+  {
+    hash ^= *c;
+    hash *= 16777619u;
+  }
+
+  return hash;
+}
+
+template <typename T, typename Traits = ResourceTraits<T> >
+class ResourceCache
+{
+public:
+  typedef ResourceHandle<T> Handle;
+
+  /**
+  * \fn ResourceCache::ResourceCache(size_t budget)
+  * \brief Creates an empty cache.
+  * \param budget The memory, in bytes, above which unreferenced resources are evicted.
+  */
+  explicit ResourceCache(size_t budget) :
+  _budget(budget),
+  _memoryUsed(0),
+  _lruHead(kNone),
+  _lruTail(kNone),
+  _freeSlot(kNone),
+  _evictionCount(0)
+  {
+  }
+
+  /**
+  * \fn ResourceCache::~ResourceCache()
+  * \brief Frees every resource, referenced or not.
+  */
+  ~ResourceCache()
+  {
+    for (Uint32 i = 0; i < _slots.size(); i++)
+    {
+      if (_slots[i].resource != nullptr)
+      {
+        Traits::Free(_slots[i].resource);
+      }
+    }
+  }
+
+  /**
+  * \fn Handle ResourceCache::Acquire(const char *path)
+  * \brief Gets a reference to the resource loaded from path, loading it if it isn't cached.
+  * \return The handle, invalid if the resource couldn't be loaded.
+  */
+  Handle Acquire(const char *path)
+  {
+    Handle handle = Find(path);
+    if (handle.IsValid())
+    {
+      return handle;
+    }
+
+    T *resource = Traits::Load(path);
+    if (resource == nullptr)
+    {
+      return Handle();
+    }
+
+    return Insert(path, resource);
+  }
+
+  /**
+  * \fn Handle ResourceCache::Find(const char *path)
+  * \brief Gets a reference to the resource loaded from path, if it is cached.
+  * \return The handle, invalid if the resource isn't cached. Nothing is loaded.
+  */
+  Handle Find(const char *path)
+  {
+    Uint32 index = FindSlot(HashResourcePath(path), path);
+    if (index == kNone)
+    {
+      return Handle();
+    }
+
+    AddReference(index);
+    return MakeHandle(index);
+  }
+
+  /**
+  * \fn Handle ResourceCache::Insert(const char *path, T *resource)
+  * \brief Gives a resource loaded elsewhere (eg. on a worker thread) to the cache, and gets a reference to it.
+  * If the path is already cached, the given resource is freed and the cached one is referenced instead.
+  */
+  Handle Insert(const char *path, T *resource)
+  {
+    Uint32 hash = HashResourcePath(path);
+    Uint32 index = FindSlot(hash, path);
+    if (index != kNone)
+    {
+      Traits::Free(resource);
+      AddReference(index);
+      return MakeHandle(index);
+    }
+
+    index = AllocateSlot();
+    Slot &slot = _slots[index];
+    slot.resource = resource;
+    slot.refCount = 1;
+    slot.hash = hash;
+    slot.path = path;
+    slot.size = Traits::GetSize(resource);
+    _memoryUsed += slot.size;
+    _slotForHash.insert(std::make_pair(hash, index));
+
+    Trim();
+    return MakeHandle(index);
+  }
+
+  /**
+  * \fn void ResourceCache::Release(Handle handle)
+  * \brief Drops a reference. Once a resource is unreferenced it can be evicted.
+  */
+  void Release(Handle handle)
+  {
+    if (IsCurrent(handle) == false || _slots[handle.index].refCount == 0)
+    {
+      return;
+    }
+
+    Slot &slot = _slots[handle.index];
+    slot.refCount--;
+    if (slot.refCount == 0)
+    {
+      LinkLru(handle.index);
+      Trim();
+    }
+  }
+
+  /**
+  * \fn T* ResourceCache::Get(Handle handle) const
+  * \brief Gets the resource of a handle.
+  * \return The resource, NULL if the handle is invalid or its resource was evicted.
+  */
+  T* Get(Handle handle) const
+  {
+    return IsCurrent(handle) ? _slots[handle.index].resource : nullptr;
+  }
+
+  /**
+  * \fn void ResourceCache::SetBudget(size_t budget)
+  * \brief Changes the budget, evicting straight away if the cache is now over it.
+  */
+  void SetBudget(size_t budget)
+  {
+    _budget = budget;
+    Trim();
+  }
+
+  /**
+  * \fn void ResourceCache::EvictUnreferenced()
+  * \brief Frees every unreferenced resource, whatever the budget.
+  */
+  void EvictUnreferenced()
+  {
+    while (_lruHead != kNone)
+    {
+      Evict(_lruHead);
+    }
+  }
+
+  size_t GetBudget() const { return _budget; }
+  size_t GetMemoryUsed() const { return _memoryUsed; }
+  Uint32 GetEvictionCount() const { return _evictionCount; }
+
+protected:
+  static const Uint32 kNone = 0xFFFFFFFF;
+
+  struct Slot
+  {
+    T *resource;
+    Uint32 generation;
+    Uint32 refCount;
+    Uint32 hash;
+    std::string path;
+    size_t size;
+
+    // Unreferenced slots form the LRU list, free slots reuse next as the free list.
+    Uint32 prev, next;
+  };
+
+  // The slot holding path, kNone if it isn't cached.
+  Uint32 FindSlot(Uint32 hash, const char *path) const
+  {
+    auto range = _slotForHash.equal_range(hash);
+    for (auto itr = range.first; itr != range.second; itr++)
+    {
+      if (_slots[itr->second].path == path)
+      {
+        return itr->second;
+      }
+    }
+
+    return kNone;
+  }
+
+  bool IsCurrent(Handle handle) const
+  {
+    return handle.index < _slots.size() && _slots[handle.index].generation == handle.generation &&
+      _slots[handle.index].resource != nullptr;
+  }
+
+  Handle MakeHandle(Uint32 index) const
+  {
+    Handle handle;
+    handle.index = index;
+    handle.generation = _slots[index].generation;
+    return handle;
+  }
+
+  void AddReference(Uint32 index)
+  {
+    Slot &slot = _slots[index];
+    if (slot.refCount == 0)
+    {
+      UnlinkLru(index);
+    }
+    slot.refCount++;
+  }
+
+  Uint32 AllocateSlot()
+  {
+    if (_freeSlot != kNone)
+    {
+      Uint32 index = _freeSlot;
+      _freeSlot = _slots[index].next;
+      return index;
+    }
+
+    Slot slot;
+    slot.resource = nullptr;
+    slot.generation = 1;
+    slot.refCount = 0;
+    slot.hash = 0;
+    slot.size = 0;
+    slot.prev = slot.next = kNone;
+    _slots.push_back(slot);
+    return (Uint32)_slots.size() - 1;
+  }
+
+  void Trim()
+  {
+    while (_memoryUsed > _budget && _lruHead != kNone)
+    {
+      Evict(_lruHead);
+    }
+  }
+
+  void Evict(Uint32 index)
+  {
+    Slot &slot = _slots[index];
+    UnlinkLru(index);
+
+    auto range = _slotForHash.equal_range(slot.hash);
+    for (auto itr = range.first; itr != range.second; itr++)
+    {
+      if (itr->second == index)
+      {
+        _slotForHash.erase(itr);
+        break;
+      }
+    }
+
+    Traits::Free(slot.resource);
+    _memoryUsed -= slot.size;
+    _evictionCount++;
+
+    // Bumping the generation invalidates every handle still pointing here.
+    slot.resource = nullptr;
+    slot.generation++;
+    if (slot.generation == 0)
+    {
+      slot.generation = 1;
+    }
+    slot.path.clear();
+    slot.size = 0;
+    slot.next = _freeSlot;
+    _freeSlot = index;
+  }
+
+  void LinkLru(Uint32 index)
+  {
+    Slot &slot = _slots[index];
+    slot.prev = _lruTail;
+    slot.next = kNone;
+    if (_lruTail != kNone)
+    {
+      _slots[_lruTail].next = index;
+    }
+    else
+    {
+      _lruHead = index;
+    }
+    _lruTail = index;
+  }
+
+  void UnlinkLru(Uint32 index)
+  {
+    Slot &slot = _slots[index];
+    if (slot.prev != kNone)
+    {
+      _slots[slot.prev].next = slot.next;
+    }
+    else
+    {
+      _lruHead = slot.next;
+    }
+
+    if (slot.next != kNone)
+    {
+      _slots[slot.next].prev = slot.prev;
+    }
+    else
+    {
+      _lruTail = slot.prev;
+    }
+
+    slot.prev = slot.next = kNone;
+  }
+
+  std::vector<Slot> _slots;
+  std::unordered_multimap<Uint32, Uint32> _slotForHash;
+
+  size_t _budget;
+  size_t _memoryUsed;
+
+  // Least recently released at the head, evicted first.
+  Uint32 _lruHead, _lruTail;
+  Uint32 _freeSlot;
+  Uint32 _evictionCount;
+};
\ No newline at end of file
@@ -0,0 +1,180 @@
+#include "ResourceManager.h"
+#include "CookedFormats.h"
+#include <SDL_image.h>
+#include <SDL_mixer.h>
+#include <mutex>
+#include <string.h>
+
+// Unreferenced resources are kept around until their cache goes over these.
+static const size_t kSoundBudget = 32 * 1024 * 1024;
+static const size_t kImageBudget = 64 * 1024 * 1024;
+
+// Loads a sound the AssetCooker stored in the mounted archive. Sounds cooked for the format the mixer is
+// running at play straight from the mapping; anything else gets an owned, converted copy.
+static Mix_Chunk* LoadCookedSound(const char *path)
+{
+  const PackedArchive &archive = ResourceManager::GetInstance()->GetArchive();
+  const ArchiveEntry *entry = archive.Find(path);
+  if (entry == nullptr || entry->size < sizeof(CookedSoundHeader))
+  {
+    return nullptr;
+  }
+
+  std::vector<Uint8> buffer;
+  const Uint8 *data = archive.GetData(entry, buffer);
+  const CookedSoundHeader *header = (const CookedSoundHeader *)data;
+  if (data == nullptr || header->magic != kCookedSoundMagic || header->byteCount > entry->size - sizeof(CookedSoundHeader))
+  {
+    return nullptr;
+  }
+
+  int frequency, channels;
+  Uint16 format;
+  if (Mix_QuerySpec(&frequency, &format, &channels) == 0)
+  {
+    return nullptr;
+  }
+
+  Uint8 *pcm = (Uint8 *)(data + sizeof(CookedSoundHeader));
+  bool isMapped = buffer.empty();
+  if (isMapped && (int)header->frequency == frequency && header->format == format && header->channels == channels)
+  {
+    return Mix_QuickLoad_RAW(pcm, header->byteCount);
+  }
+
+  SDL_AudioCVT converter;
+  if (SDL_BuildAudioCVT(&converter, header->format, header->channels, header->frequency, format, (Uint8)channels, frequency) < 0)
+  {
+    return nullptr;
+  }
+
+  converter.len = (int)header->byteCount;
+  converter.buf = (Uint8 *)SDL_malloc(converter.len * converter.len_mult);
+  if (converter.buf == nullptr)
+  {
+    return nullptr;
+  }
+
+  memcpy(converter.buf, pcm, header->byteCount);
+  SDL_ConvertAudio(&converter);
+
+  Mix_Chunk *chunk = Mix_QuickLoad_RAW(converter.buf, converter.len_cvt);
+  if (chunk == nullptr)
+  {
+    SDL_free(converter.buf);
+    return nullptr;
+  }
+
+  // Let Mix_FreeChunk free the copy.
+  chunk->allocated = 1;
+  return chunk;
+}
+
+Mix_Chunk* ResourceTraits<Mix_Chunk>::Load(const char *path)
+{
+  Mix_Chunk *chunk = LoadCookedSound(path);
+  if (chunk != nullptr)
+  {
+    return chunk;
+  }
+
+  SDL_RWops *file = ResourceManager::GetInstance()->OpenFile(path);
+  return (file != nullptr) ? Mix_LoadWAV_RW(file, 1) : nullptr;
+}
+
+void ResourceTraits<Mix_Chunk>::Free(Mix_Chunk *chunk)
+{
+  Mix_FreeChunk(chunk);
+}
+
+size_t ResourceTraits<Mix_Chunk>::GetSize(const Mix_Chunk *chunk)
+{
+  return sizeof(Mix_Chunk) + chunk->alen;
+}
+
+SDL_Surface* ResourceTraits<SDL_Surface>::Load(const char *path)
+{
+  // Loading the image codecs is slow and most runs never load an image, so it waits for the first one.
+  // IMG_Init isn't thread safe and images load from the thread pool, hence the once_flag.
+  static std::once_flag imageInit;
+  std::call_once(imageInit, []()
+  {
+    IMG_Init(IMG_INIT_JPG | IMG_INIT_PNG | IMG_INIT_TIF | IMG_INIT_WEBP);
+  });
+
+  SDL_RWops *file = ResourceManager::GetInstance()->OpenFile(path);
+  return (file != nullptr) ? IMG_Load_RW(file, 1) : nullptr;
+}
+
+void ResourceTraits<SDL_Surface>::Free(SDL_Surface *surface)
+{
+  SDL_FreeSurface(surface);
+}
+
+size_t ResourceTraits<SDL_Surface>::GetSize(const SDL_Surface *surface)
+{
+  return sizeof(SDL_Surface) + surface->pitch * surface->h;
+}
+
+ResourceManager* ResourceManager::_instance = NULL;
+
+ResourceManager* ResourceManager::GetInstance()
+{
+  if (_instance == NULL)
+  {
+    _instance = new ResourceManager();
+  }
+
+  return _instance;
+}
+
+void ResourceManager::DestroyInstance()
+{
+  if (_instance != NULL)
+  {
+    delete _instance;
+    _instance = NULL;
+  }
+}
+
+ResourceManager::ResourceManager() :
+_sounds(kSoundBudget),
+_images(kImageBudget)
+{
+}
+
+bool ResourceManager::MountArchive(const char *path)
+{
+  return _archive.Open(path);
+}
+
+SDL_RWops* ResourceManager::OpenFile(const char *path)
+{
+  SDL_RWops *file = _archive.OpenRW(path);
+  if (file == nullptr)
+  {
+    file = SDL_RWFromFile(path, "rb");
+  }
+
+  return file;
+}
+
+const PackedArchive& ResourceManager::GetArchive() const
+{
+  return _archive;
+}
+
+SoundCache& ResourceManager::GetSounds()
+{
+  return _sounds;
+}
+
+ImageCache& ResourceManager::GetImages()
+{
+  return _images;
+}
+
+size_t ResourceManager::GetMemoryUsed() const
+{
+  return _sounds.GetMemoryUsed() + _images.GetMemoryUsed();
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+/**
+ * \class ResourceManager
+ * \brief A singleton holding one ResourceCache per resource type, so screens and systems share what is loaded.
+ */
+
+#pragma once
+#include "PackedArchive.h"
+#include "ResourceCache.h"
+#include <stddef.h>
+
+struct Mix_Chunk;
+struct SDL_RWops;
+struct SDL_Surface;
+
+template <>
+struct ResourceTraits<Mix_Chunk>
+{
+  static Mix_Chunk* Load(const char *path);
+  static void Free(Mix_Chunk *chunk);
+  static size_t GetSize(const Mix_Chunk *chunk);
+};
+
+template <>
+struct ResourceTraits<SDL_Surface>
+{
+  static SDL_Surface* Load(const char *path);
+  static void Free(SDL_Surface *surface);
+  static size_t GetSize(const SDL_Surface *surface);
+};
+
+typedef ResourceCache<Mix_Chunk> SoundCache;
+typedef ResourceCache<SDL_Surface> ImageCache;
+
+class ResourceManager
+{
+public:
+  /**
+  * \fn static ResourceManager* ResourceManager::GetInstance()
+  * \brief A static method to get the single instance of this class.
+  * \return The single ResourceManager instance.
+  */
+  static ResourceManager* GetInstance();
+
+  /**
+  * \fn static void ResourceManager::DestroyInstance()
+  * \brief A static method to destroy the single instance of this class, freeing every resource.
+  */
+  static void DestroyInstance();
+
+  /**
+  * \fn bool ResourceManager::MountArchive(const char *path)
+  * \brief Maps a packed archive whose assets take precedence over loose files from then on.
+  * Mount before any loading starts; the archive is read from the loader threads without locking.
+  * \param path The archive file, built by PackedArchiveWriter.
+  * \return Whether or not the archive could be mapped.
+  */
+  bool MountArchive(const char *path);
+
+  /**
+  * \fn SDL_RWops* ResourceManager::OpenFile(const char *path)
+  * \brief Opens an asset from the mounted archive, or from disk if the archive doesn't hold it.
+  * Safe to call from any thread.
+  * \param path The asset path, eg. "res/boing2.wav".
+  * \return The stream, to be closed by the caller. NULL if the asset can't be found.
+  */
+  SDL_RWops* OpenFile(const char *path);
+
+  /**
+  * \fn const PackedArchive& ResourceManager::GetArchive() const
+  * \brief Gets the mounted archive, for loaders reading cooked assets in place. It is empty if none was mounted.
+  */
+  const PackedArchive& GetArchive() const;
+
+  SoundCache& GetSounds();
+  ImageCache& GetImages();
+
+  /**
+  * \fn size_t ResourceManager::GetMemoryUsed() const
+  * \brief Gets the memory used by every cache together, in bytes.
+  */
+  size_t GetMemoryUsed() const;
+
+protected:
+  /**
+  * \fn ResourceManager::ResourceManager()
+  * \brief Creates the caches with their default budgets.
+  */
+  ResourceManager();
+
+  static ResourceManager *_instance;
+
+  PackedArchive _archive;
+
+  SoundCache _sounds;
+  ImageCache _images;
+};
\ No newline at end of file
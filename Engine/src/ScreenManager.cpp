@@ -31,10 +31,10 @@ ScreenManager::ScreenManager()
 
 ScreenManager::~ScreenManager()
 {
-  SDL_DestroyTexture(mDefaultTarget);
+  SDL_DestroyTexture(_defaultTarget);
 
-  SDL_DestroyRenderer(mRenderer);
-  SDL_DestroyWindow(mWindow);
+  SDL_DestroyRenderer(_renderer);
+  SDL_DestroyWindow(_window);
 
   SDL_Quit();
 }
@@ -98,17 +98,30 @@ void ScreenManager::Update()
 {
   if (_isRunning)
   {
-    SDL_Event e;
-    SDL_PollEvent(&e);
+    // Hand the active screen everything that queued up since the last frame.
+    _eventBatch.Drain();
 
-    if (_activeScreen)
+    for (int i = 0; i < _eventBatch.GetCount() && _isRunning; i++)
     {
-      _activeScreen->Update(e, 0.0f);
+      const SDL_Event &e = _eventBatch.GetEvent(i);
+
+      if (_activeScreen)
+      {
+        _activeScreen->Update(e, 0.0f);
+      }
+
+      if (e.type == SDL_QUIT)
+      {
+        _isRunning = false;
+      }
     }
 
-    if (e.type == SDL_QUIT)
+    // Screens still get their once-per-frame update on quiet frames.
+    if (_eventBatch.GetCount() == 0 && _activeScreen)
     {
-      _isRunning = false;
+      SDL_Event idle;
+      SDL_memset(&idle, 0, sizeof(idle));
+      _activeScreen->Update(idle, 0.0f);
     }
   }
 }
@@ -1,10 +1,12 @@
 #pragma once
+#include "EventBatch.h"
 #include <SDL_events.h>
 #include <map>
 #include <string>
 
 struct SDL_Renderer;
 struct SDL_Texture;
+struct SDL_Window;
 class Screen;
 
 class ScreenManager
@@ -42,4 +44,6 @@ protected:
   SDL_Texture *_defaultTarget;
 
   bool _isRunning;
+
+  EventBatch _eventBatch;
 };
\ No newline at end of file
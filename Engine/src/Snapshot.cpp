@@ -0,0 +1,51 @@
+#include "Snapshot.h"
+#include <string.h>
+
+Snapshot::Snapshot() :
+_readOffset(0)
+{
+}
+
+void Snapshot::Clear()
+{
+  _data.clear();
+  _readOffset = 0;
+}
+
+void Snapshot::Write(const void *data, size_t size)
+{
+  const Uint8 *bytes = (const Uint8 *)data;
+  _data.insert(_data.end(), bytes, bytes + size);
+}
+
+void Snapshot::BeginRead()
+{
+  _readOffset = 0;
+}
+
+bool Snapshot::Read(void *data, size_t size)
+{
+  if (size > _data.size() - _readOffset)
+  {
+    return false;
+  }
+
+  if (size == 0)
+  {
+    return true;
+  }
+
+  memcpy(data, &_data[_readOffset], size);
+  _readOffset += size;
+  return true;
+}
+
+size_t Snapshot::GetSize() const
+{
+  return _data.size();
+}
+
+const Uint8* Snapshot::GetData() const
+{
+  return _data.empty() ? nullptr : &_data[0];
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+/**
+ * \class Snapshot
+ * \brief A flat byte buffer that game state is saved into and restored from with bulk copies.
+ *
+ * Values and arrays are appended in the order they are written and read back in the same order; there are no
+ * names or per-field headers. Only types that can be copied with memcpy (no pointers, no owned memory) can be
+ * written. Clearing keeps the buffer's memory, so a snapshot taken every tick stops allocating after the first.
+ */
+
+#pragma once
+#include <SDL_stdinc.h>
+#include <vector>
+
+class Snapshot
+{
+public:
+  /**
+  * \fn Snapshot::Snapshot()
+  * \brief Creates an empty snapshot.
+  */
+  Snapshot();
+
+  /**
+  * \fn void Snapshot::Clear()
+  * \brief Empties the snapshot so it can be written again, keeping its memory.
+  */
+  void Clear();
+
+  /**
+  * \fn void Snapshot::Write(const void *data, size_t size)
+  * \brief Appends raw bytes to the snapshot.
+  */
+  void Write(const void *data, size_t size);
+
+  template <typename T>
+  void Write(const T &value)
+  {
+    Write(&value, sizeof(T));
+  }
+
+  /**
+  * \fn void Snapshot::WriteVector<T>(const std::vector<T> &values)
+  * \brief Appends the element count followed by every element in one copy.
+  */
+  template <typename T>
+  void WriteVector(const std::vector<T> &values)
+  {
+    Uint32 count = (Uint32)values.size();
+    Write(count);
+    if (count > 0)
+    {
+      Write(&values[0], count * sizeof(T));
+    }
+  }
+
+  /**
+  * \fn void Snapshot::BeginRead()
+  * \brief Moves back to the start of the snapshot so it can be read (again).
+  */
+  void BeginRead();
+
+  /**
+  * \fn bool Snapshot::Read(void *data, size_t size)
+  * \brief Copies the next bytes of the snapshot out.
+  * \return false, leaving data alone, if the snapshot has fewer bytes left.
+  */
+  bool Read(void *data, size_t size);
+
+  template <typename T>
+  bool Read(T &value)
+  {
+    return Read(&value, sizeof(T));
+  }
+
+  /**
+  * \fn bool Snapshot::ReadVector<T>(std::vector<T> &values)
+  * \brief Replaces the contents of the vector with an array written by WriteVector. Reuses the vector's memory
+  * when the array fits.
+  */
+  template <typename T>
+  bool ReadVector(std::vector<T> &values)
+  {
+    Uint32 count;
+    if (Read(count) == false || count * sizeof(T) > _data.size() - _readOffset)
+    {
+      return false;
+    }
+
+    values.resize(count);
+    return count == 0 || Read(&values[0], count * sizeof(T));
+  }
+
+  size_t GetSize() const;
+  const Uint8* GetData() const;
+
+protected:
+  std::vector<Uint8> _data;
+  size_t _readOffset;
+};
\ No newline at end of file
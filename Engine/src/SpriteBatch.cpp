@@ -0,0 +1,189 @@
+#include "SpriteBatch.h"
+#include "GraphicsSDL.h"
+#include "TextureAtlas.h"
+#include <SDL.h>
+#include <algorithm>
+
+SpriteBatch::SpriteBatch(GraphicsSDL *graphics) :
+_graphics(graphics),
+_cacheTarget(nullptr),
+_cacheWidth(0),
+_cacheHeight(0),
+_cachingEnabled(false),
+_cacheValid(false),
+_hasTranslucent(false)
+{
+  _commands.reserve(256);
+  _previousCommands.reserve(256);
+}
+
+SpriteBatch::~SpriteBatch()
+{
+  if (_cacheTarget != nullptr)
+  {
+    SDL_DestroyTexture(_cacheTarget);
+  }
+}
+
+void SpriteBatch::Begin()
+{
+  _commands.clear();
+  _hasTranslucent = false;
+}
+
+void SpriteBatch::Draw(TextureAtlas *atlas, int region, const SDL_Rect &dest, int layer)
+{
+  SpriteCommand command;
+  command.layer = layer;
+  command.order = (int)_commands.size();
+  command.texture = atlas->GetTexture();
+  command.source = atlas->GetRegion(region);
+  command.dest = dest;
+
+  _commands.push_back(command);
+
+  if (atlas->IsTranslucent(region))
+  {
+    _hasTranslucent = true;
+  }
+}
+
+void SpriteBatch::End()
+{
+  SDL_Renderer *renderer = _graphics->GetRenderer();
+
+  // Group the sprites by layer, then by texture, keeping submission order within a group.
+  std::sort(_commands.begin(), _commands.end(), CompareCommands);
+
+  // Translucent sprites would have their alpha applied twice through the cache, so they are drawn directly.
+  if (_cachingEnabled && _hasTranslucent == false && PrepareCacheTarget())
+  {
+    if (_cacheValid == false || IsSameAsPrevious() == false)
+    {
+      SDL_Texture *previousTarget = SDL_GetRenderTarget(renderer);
+      SDL_SetRenderTarget(renderer, _cacheTarget);
+      _graphics->RecordStateChange();
+
+      // Clear the cache to transparent without disturbing the caller's draw colour.
+      Uint8 r, g, b, a;
+      SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+      SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+      SDL_RenderClear(renderer);
+      SDL_SetRenderDrawColor(renderer, r, g, b, a);
+
+      Submit();
+
+      SDL_SetRenderTarget(renderer, previousTarget);
+      _graphics->RecordStateChange();
+
+      _previousCommands.swap(_commands);
+      _cacheValid = true;
+    }
+
+    SDL_RenderCopy(renderer, _cacheTarget, nullptr, nullptr);
+    _graphics->RecordTextureBind();
+    _graphics->RecordDrawCall(2, 4, 0);
+  }
+  else
+  {
+    Submit();
+  }
+
+  _commands.clear();
+}
+
+void SpriteBatch::SetCaching(bool enabled)
+{
+  _cachingEnabled = enabled;
+  _cacheValid = false;
+  _previousCommands.clear();
+}
+
+bool SpriteBatch::CompareCommands(const SpriteCommand &first, const SpriteCommand &second)
+{
+  if (first.layer != second.layer)
+  {
+    return first.layer < second.layer;
+  }
+
+  if (first.texture != second.texture)
+  {
+    return first.texture < second.texture;
+  }
+
+  return first.order < second.order;
+}
+
+void SpriteBatch::Submit()
+{
+  SDL_Renderer *renderer = _graphics->GetRenderer();
+  SDL_Texture *boundTexture = nullptr;
+  for (auto itr = _commands.begin(); itr != _commands.end(); itr++)
+  {
+    if (itr->texture != boundTexture)
+    {
+      boundTexture = itr->texture;
+      _graphics->RecordTextureBind();
+    }
+
+    SDL_RenderCopy(renderer, itr->texture, &itr->source, &itr->dest);
+    _graphics->RecordDrawCall(2, 4, 0);
+  }
+}
+
+bool SpriteBatch::IsSameAsPrevious() const
+{
+  if (_commands.size() != _previousCommands.size())
+  {
+    return false;
+  }
+
+  for (size_t i = 0; i < _commands.size(); i++)
+  {
+    const SpriteCommand &current = _commands[i];
+    const SpriteCommand &previous = _previousCommands[i];
+    if (current.texture != previous.texture || current.layer != previous.layer ||
+      SDL_RectEquals(&current.source, &previous.source) == SDL_FALSE ||
+      SDL_RectEquals(&current.dest, &previous.dest) == SDL_FALSE)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool SpriteBatch::PrepareCacheTarget()
+{
+  SDL_Renderer *renderer = _graphics->GetRenderer();
+  if (SDL_RenderTargetSupported(renderer) == SDL_FALSE)
+  {
+    return false;
+  }
+
+  int width, height;
+  SDL_GetRendererOutputSize(renderer, &width, &height);
+
+  // Recreate the target if the output was resized.
+  if (_cacheTarget != nullptr && (width != _cacheWidth || height != _cacheHeight))
+  {
+    SDL_DestroyTexture(_cacheTarget);
+    _cacheTarget = nullptr;
+  }
+
+  if (_cacheTarget == nullptr)
+  {
+    _cacheTarget = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+    if (_cacheTarget == nullptr)
+    {
+      return false;
+    }
+
+    SDL_SetTextureBlendMode(_cacheTarget, SDL_BLENDMODE_BLEND);
+    _cacheWidth = width;
+    _cacheHeight = height;
+    _cacheValid = false;
+  }
+
+  return true;
+}
\ No newline at end of file
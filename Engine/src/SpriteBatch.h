@@ -0,0 +1,94 @@
+/**
+ * \class SpriteBatch
+ * \brief Collects the sprites drawn through GraphicsSDL during a frame and submits them in texture order.
+ *
+ * Sprites are sorted by layer and then by atlas texture so each atlas is bound once per layer.
+ * When caching is enabled and the frame's sprites are identical to the previous frame's
+ * (a static menu or HUD), the batch is replayed from a render target with a single copy.
+ * Only batches of opaque sprites (alpha 0 or 255) are cached: a translucent sprite would be blended into the
+ * target and then blended onto the screen again, and SDL has no premultiplied blend mode to undo that.
+ */
+
+#pragma once
+#include <SDL_rect.h>
+#include <vector>
+
+class GraphicsSDL;
+class TextureAtlas;
+struct SDL_Texture;
+
+class SpriteBatch
+{
+public:
+  /**
+  * \fn SpriteBatch::SpriteBatch(GraphicsSDL *graphics)
+  * \brief Creates a sprite batch that draws with the given SDL graphics object.
+  * \param graphics The graphics object whose renderer the sprites are submitted to.
+  */
+  SpriteBatch(GraphicsSDL *graphics);
+
+  /**
+  * \fn SpriteBatch::~SpriteBatch()
+  * \brief Frees the cache render target.
+  */
+  ~SpriteBatch();
+
+  /**
+  * \fn void SpriteBatch::Begin()
+  * \brief Starts collecting sprites for a new batch.
+  */
+  void Begin();
+
+  /**
+  * \fn void SpriteBatch::Draw(TextureAtlas *atlas, int region, const SDL_Rect &dest, int layer)
+  * \brief Queues a sprite. Nothing is submitted to the renderer until End.
+  * \param atlas The atlas the sprite was packed into.
+  * \param region The region index returned by TextureAtlas::AddImage.
+  * \param dest Where to draw the sprite on screen.
+  * \param layer Sprites on lower layers are drawn first. Order between atlases is only kept across layers.
+  */
+  void Draw(TextureAtlas *atlas, int region, const SDL_Rect &dest, int layer = 0);
+
+  /**
+  * \fn void SpriteBatch::End()
+  * \brief Sorts the queued sprites and submits them to the renderer, through the cache if it is enabled and every
+  * sprite of the batch is opaque.
+  */
+  void End();
+
+  /**
+  * \fn void SpriteBatch::SetCaching(bool enabled)
+  * \brief Enables replaying unchanged batches of opaque sprites from a render target.
+  * \param enabled Whether or not unchanged batches should be cached.
+  */
+  void SetCaching(bool enabled);
+
+protected:
+  struct SpriteCommand
+  {
+    int layer;
+    int order;
+    SDL_Texture *texture;
+    SDL_Rect source;
+    SDL_Rect dest;
+  };
+
+  static bool CompareCommands(const SpriteCommand &first, const SpriteCommand &second);
+
+  void Submit();
+  bool IsSameAsPrevious() const;
+  bool PrepareCacheTarget();
+
+  GraphicsSDL *_graphics;
+
+  std::vector<SpriteCommand> _commands;
+  std::vector<SpriteCommand> _previousCommands;
+
+  SDL_Texture *_cacheTarget;
+  int _cacheWidth, _cacheHeight;
+  bool _cachingEnabled;
+  bool _cacheValid;
+
+  // Whether a sprite queued since Begin has partial alpha, such batches bypass the cache.
+  bool _hasTranslucent;
+};
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include "StateGrid.h"
+#include <stdio.h>
+
+StateGrid::StateGrid() :
+_listenerCount(0)
+{
+  for (int i = 0; i < kMaxStates; i++)
+  {
+    _counts[i] = 0;
+  }
+}
+
+void StateGrid::Resize(int rows, int columns, Uint8 state)
+{
+  _cells.Resize(rows, columns, state);
+
+  for (int i = 0; i < kMaxStates; i++)
+  {
+    _counts[i] = 0;
+  }
+  _counts[state] = rows * columns;
+}
+
+void StateGrid::Reserve(int count)
+{
+  _cells.Reserve(count);
+}
+
+bool StateGrid::Set(int row, int column, Uint8 state)
+{
+  Uint8 &cell = _cells(row, column);
+  if (cell == state)
+  {
+    return false;
+  }
+
+  StateChange change = { row, column, cell, state };
+  _counts[cell]--;
+  _counts[state]++;
+  cell = state;
+
+  for (int i = 0; i < _listenerCount; i++)
+  {
+    _listeners[i](change);
+  }
+
+  return true;
+}
+
+Uint8 StateGrid::Get(int row, int column) const
+{
+  return _cells(row, column);
+}
+
+int StateGrid::GetCount(Uint8 state) const
+{
+  return _counts[state];
+}
+
+int StateGrid::GetRows() const
+{
+  return _cells.GetRows();
+}
+
+int StateGrid::GetColumns() const
+{
+  return _cells.GetColumns();
+}
+
+bool StateGrid::Contains(int row, int column) const
+{
+  return _cells.Contains(row, column);
+}
+
+void StateGrid::Save(Snapshot &snapshot) const
+{
+  Sint32 rows = _cells.GetRows();
+  Sint32 columns = _cells.GetColumns();
+  snapshot.Write(rows);
+  snapshot.Write(columns);
+  snapshot.Write(_counts);
+  if (_cells.GetCount() > 0)
+  {
+    snapshot.Write(_cells.GetRow(0), _cells.GetCount());
+  }
+}
+
+bool StateGrid::Restore(Snapshot &snapshot)
+{
+  Sint32 rows, columns;
+  if (snapshot.Read(rows) == false || snapshot.Read(columns) == false || snapshot.Read(_counts) == false)
+  {
+    return false;
+  }
+
+  _cells.Resize(rows, columns);
+  return _cells.GetCount() == 0 || snapshot.Read(_cells.GetRow(0), _cells.GetCount());
+}
+
+void StateGrid::AddListener(const StateDelegate &listener)
+{
+  for (int i = 0; i < _listenerCount; i++)
+  {
+    if (_listeners[i] == listener)
+    {
+      return;
+    }
+  }
+
+  if (_listenerCount == kMaxListeners)
+  {
+    printf("StateGrid: no room for another listener\n");
+    return;
+  }
+
+  _listeners[_listenerCount++] = listener;
+}
+
+void StateGrid::RemoveListener(const StateDelegate &listener)
+{
+  for (int i = 0; i < _listenerCount; i++)
+  {
+    if (_listeners[i] == listener)
+    {
+      _listeners[i] = _listeners[--_listenerCount];
+      _listeners[_listenerCount] = StateDelegate();
+      return;
+    }
+  }
+}
\ No newline at end of file
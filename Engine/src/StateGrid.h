@@ -0,0 +1,118 @@
+/**
+ * \class StateGrid
+ * \brief A Grid of small per-cell states that keeps a running count of the cells in each state and tells
+ * listeners about every change.
+ *
+ * Every change goes through Set, so questions like "is any cell still in state 0?" are answered from the counts
+ * in constant time instead of by scanning the grid, and renderers can update just the cells that changed.
+ */
+
+#pragma once
+#include "Delegate.h"
+#include "Grid.h"
+#include "Snapshot.h"
+#include <SDL_stdinc.h>
+
+struct StateChange
+{
+  int row, column;
+  Uint8 previous;
+  Uint8 current;
+};
+
+typedef Delegate<const StateChange &> StateDelegate;
+
+class StateGrid
+{
+public:
+  static const int kMaxStates = 16;
+  static const int kMaxListeners = 4;
+
+  /**
+  * \fn StateGrid::StateGrid()
+  * \brief Creates an empty grid.
+  */
+  StateGrid();
+
+  /**
+  * \fn void StateGrid::Resize(int rows, int columns, Uint8 state)
+  * \brief Changes the size of the grid and puts every cell in the given state. Listeners aren't told; anything
+  * mirroring the grid has to be rebuilt along with it. Reuses the grid's memory when it fits.
+  */
+  void Resize(int rows, int columns, Uint8 state);
+
+  /**
+  * \fn void StateGrid::Reserve(int count)
+  * \brief Allocates room for the given number of cells up front.
+  */
+  void Reserve(int count);
+
+  /**
+  * \fn bool StateGrid::Set(int row, int column, Uint8 state)
+  * \brief Changes the state of a cell, updating the counts and telling the listeners.
+  * \param state The new state, below kMaxStates.
+  * \return true if the cell was in a different state, false if nothing changed.
+  */
+  bool Set(int row, int column, Uint8 state);
+
+  Uint8 Get(int row, int column) const;
+
+  /**
+  * \fn int StateGrid::GetCount(Uint8 state) const
+  * \brief Gets how many cells are in the given state.
+  */
+  int GetCount(Uint8 state) const;
+
+  int GetRows() const;
+  int GetColumns() const;
+  bool Contains(int row, int column) const;
+
+  /**
+  * \fn void StateGrid::Save(Snapshot &snapshot) const
+  * \brief Appends the size, counts and cell states to a snapshot.
+  */
+  void Save(Snapshot &snapshot) const;
+
+  /**
+  * \fn bool StateGrid::Restore(Snapshot &snapshot)
+  * \brief Reads back what Save wrote. Like Resize, listeners aren't told.
+  * \return false if the snapshot ran out, the grid is left in an unspecified state.
+  */
+  bool Restore(Snapshot &snapshot);
+
+  /**
+  * \fn void StateGrid::AddListener<T, Method>(T *target)
+  * \brief Calls the given member function on the target whenever a cell changes state.
+  * eg. AddListener<WorldMesh, &WorldMesh::OnTileChanged>(mesh);
+  */
+  template <class T, void (T::*Method)(const StateChange &)>
+  void AddListener(T *target)
+  {
+    AddListener(StateDelegate::FromMethod<T, Method>(target));
+  }
+
+  /**
+  * \fn void StateGrid::AddListener(const StateDelegate &listener)
+  * \brief Calls the given delegate whenever a cell changes state. Adding a listener twice does nothing.
+  */
+  void AddListener(const StateDelegate &listener);
+
+  template <class T, void (T::*Method)(const StateChange &)>
+  void RemoveListener(T *target)
+  {
+    RemoveListener(StateDelegate::FromMethod<T, Method>(target));
+  }
+
+  /**
+  * \fn void StateGrid::RemoveListener(const StateDelegate &listener)
+  * \brief Stops calling the given delegate. Not to be called from inside a notification.
+  */
+  void RemoveListener(const StateDelegate &listener);
+
+protected:
+  Grid<Uint8> _cells;
+  int _counts[kMaxStates];
+
+  StateDelegate _listeners[kMaxListeners];
+  int _listenerCount;
+};
\ No newline at end of file
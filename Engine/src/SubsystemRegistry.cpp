@@ -0,0 +1,92 @@
+#include "SubsystemRegistry.h"
+#include "Metrics.h"
+#include <SDL.h>
+#include <stdio.h>
+
+// Events come first because video and joysticks pull them in, so their time isn't counted against those.
+const SubsystemRegistry::Subsystem SubsystemRegistry::kSubsystems[kSubsystemCount] =
+{
+  { SDL_INIT_EVENTS, "events", "startup.events.seconds" },
+  { SDL_INIT_TIMER, "timer", "startup.timer.seconds" },
+  { SDL_INIT_VIDEO, "video", "startup.video.seconds" },
+  { SDL_INIT_AUDIO, "audio", "startup.audio.seconds" },
+  { SDL_INIT_JOYSTICK, "joystick", "startup.joystick.seconds" },
+  { SDL_INIT_GAMECONTROLLER, "gamecontroller", "startup.gamecontroller.seconds" },
+  { SDL_INIT_HAPTIC, "haptic", "startup.haptic.seconds" }
+};
+
+SubsystemRegistry::SubsystemRegistry() :
+_started(0),
+_totalTime(0.0)
+{
+  for (int i = 0; i < kSubsystemCount; i++)
+  {
+    _initTimes[i] = 0.0;
+  }
+}
+
+SubsystemRegistry::~SubsystemRegistry()
+{
+  Stop();
+}
+
+bool SubsystemRegistry::Start(Uint32 flags)
+{
+  Uint64 startTime = SDL_GetPerformanceCounter();
+
+  // Start the events video and joysticks need up front, so they are timed on their own.
+  if ((flags & (SDL_INIT_VIDEO | SDL_INIT_JOYSTICK | SDL_INIT_GAMECONTROLLER)) != 0)
+  {
+    flags |= SDL_INIT_EVENTS;
+  }
+
+  flags &= ~_started;
+  for (int i = 0; i < kSubsystemCount; i++)
+  {
+    const Subsystem &subsystem = kSubsystems[i];
+    if ((flags & subsystem.flag) == 0)
+    {
+      continue;
+    }
+
+    Uint64 subsystemStartTime = SDL_GetPerformanceCounter();
+    if (SDL_InitSubSystem(subsystem.flag) != 0)
+    {
+      printf("SubsystemRegistry: could not start %s: %s\n", subsystem.name, SDL_GetError());
+      continue;
+    }
+
+    _initTimes[i] = (double)(SDL_GetPerformanceCounter() - subsystemStartTime) / SDL_GetPerformanceFrequency();
+    _started |= subsystem.flag;
+  }
+
+  _totalTime += (double)(SDL_GetPerformanceCounter() - startTime) / SDL_GetPerformanceFrequency();
+  return (flags & ~_started) == 0;
+}
+
+void SubsystemRegistry::Stop()
+{
+  if (_started != 0)
+  {
+    SDL_QuitSubSystem(_started);
+    _started = 0;
+  }
+}
+
+Uint32 SubsystemRegistry::GetStarted() const
+{
+  return _started;
+}
+
+void SubsystemRegistry::ReportInitTimes(MetricsSink *sink) const
+{
+  for (int i = 0; i < kSubsystemCount; i++)
+  {
+    if ((_started & kSubsystems[i].flag) != 0)
+    {
+      sink->Record(kSubsystems[i].metricName, _initTimes[i]);
+    }
+  }
+
+  sink->Record("startup.subsystems.seconds", _totalTime);
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+/**
+ * \class SubsystemRegistry
+ * \brief Starts only the SDL subsystems an application asks for, one after the other, and times each of them.
+ *
+ * Events and timers start first since the others rely on them, then video, audio, joysticks and haptics, all on
+ * the calling thread, which has to be the one that later creates the window. SDL_InitSubSystem isn't safe to call
+ * from two threads at once: every call goes through SDL's global init state, hints and error message. The time
+ * each subsystem took is reported as "startup.<name>.seconds", along with the time of the whole start as
+ * "startup.subsystems.seconds".
+ */
+
+#pragma once
+#include <SDL_stdinc.h>
+
+class MetricsSink;
+
+class SubsystemRegistry
+{
+public:
+  /**
+  * \fn SubsystemRegistry::SubsystemRegistry()
+  * \brief Creates a registry with nothing started.
+  */
+  SubsystemRegistry();
+
+  /**
+  * \fn SubsystemRegistry::~SubsystemRegistry()
+  * \brief Stops whatever is still started.
+  */
+  ~SubsystemRegistry();
+
+  /**
+  * \fn bool SubsystemRegistry::Start(Uint32 flags)
+  * \brief Starts the requested subsystems. Subsystems that are already started are left alone.
+  * \param flags SDL_INIT_* flags of the subsystems to start.
+  * \return Whether or not every requested subsystem started. Failures are logged.
+  */
+  bool Start(Uint32 flags);
+
+  /**
+  * \fn void SubsystemRegistry::Stop()
+  * \brief Stops every subsystem this registry started.
+  */
+  void Stop();
+
+  /**
+  * \fn Uint32 SubsystemRegistry::GetStarted() const
+  * \brief Gets the SDL_INIT_* flags of the subsystems this registry started.
+  */
+  Uint32 GetStarted() const;
+
+  /**
+  * \fn void SubsystemRegistry::ReportInitTimes(MetricsSink *sink) const
+  * \brief Records how long each started subsystem took to start, in seconds, into the current frame of the sink.
+  */
+  void ReportInitTimes(MetricsSink *sink) const;
+
+protected:
+  struct Subsystem
+  {
+    Uint32 flag;
+    const char *name;
+    const char *metricName;
+  };
+
+  static const int kSubsystemCount = 7;
+
+  // In the order they are started.
+  static const Subsystem kSubsystems[kSubsystemCount];
+
+  Uint32 _started;
+  double _initTimes[kSubsystemCount];
+  double _totalTime;
+};
\ No newline at end of file
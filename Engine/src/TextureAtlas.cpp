@@ -0,0 +1,148 @@
+#include "TextureAtlas.h"
+#include "ResourceManager.h"
+#include <SDL.h>
+#include <SDL_image.h>
+#include <stdio.h>
+
+// Gap left between packed images so linear filtering doesn't bleed neighbours in.
+static const int kAtlasPadding = 1;
+
+TextureAtlas::TextureAtlas(int width, int height) :
+_texture(nullptr),
+_width(width),
+_height(height),
+_shelfX(0),
+_shelfY(0),
+_shelfHeight(0)
+{
+  _surface = SDL_CreateRGBSurface(0, width, height, 32, 0xFF000000, 0x00FF0000, 0x0000FF00, 0x000000FF);
+  if (_surface != nullptr)
+  {
+    SDL_FillRect(_surface, nullptr, 0);
+  }
+}
+
+TextureAtlas::~TextureAtlas()
+{
+  if (_surface != nullptr)
+  {
+    SDL_FreeSurface(_surface);
+  }
+
+  if (_texture != nullptr)
+  {
+    SDL_DestroyTexture(_texture);
+  }
+}
+
+int TextureAtlas::AddImage(const char *path)
+{
+  if (_surface == nullptr)
+  {
+    return -1;
+  }
+
+  // Go through the image cache so atlases packing the same image load it once.
+  ImageCache &images = ResourceManager::GetInstance()->GetImages();
+  ImageCache::Handle handle = images.Acquire(path);
+  SDL_Surface *image = images.Get(handle);
+  if (image == nullptr)
+  {
+    printf("IMG_Load: %s\n", IMG_GetError());
+    return -1;
+  }
+
+  // Start a new shelf if the image doesn't fit on the current one.
+  if (_shelfX + image->w > _width)
+  {
+    _shelfX = 0;
+    _shelfY += _shelfHeight + kAtlasPadding;
+    _shelfHeight = 0;
+  }
+
+  if (image->w > _width || _shelfY + image->h > _height)
+  {
+    printf("TextureAtlas: no room left for %s\n", path);
+    images.Release(handle);
+    return -1;
+  }
+
+  SDL_Rect region = { _shelfX, _shelfY, image->w, image->h };
+
+  // Copy the pixels as-is, alpha included, rather than blending them onto the empty atlas.
+  SDL_BlendMode blendMode;
+  SDL_GetSurfaceBlendMode(image, &blendMode);
+  SDL_SetSurfaceBlendMode(image, SDL_BLENDMODE_NONE);
+  SDL_BlitSurface(image, nullptr, _surface, &region);
+  SDL_SetSurfaceBlendMode(image, blendMode);
+  images.Release(handle);
+
+  _shelfX += region.w + kAtlasPadding;
+  if (region.h > _shelfHeight)
+  {
+    _shelfHeight = region.h;
+  }
+
+  // Partial alpha is checked in the atlas copy, whose format is known, so every image format is handled alike.
+  bool isTranslucent = false;
+  for (int y = region.y; y < region.y + region.h && isTranslucent == false; y++)
+  {
+    const Uint32 *row = (const Uint32 *)((const Uint8 *)_surface->pixels + y * _surface->pitch);
+    for (int x = region.x; x < region.x + region.w; x++)
+    {
+      Uint32 alpha = row[x] & 0x000000FF;
+      if (alpha != 0 && alpha != 0xFF)
+      {
+        isTranslucent = true;
+        break;
+      }
+    }
+  }
+
+  _regions.push_back(region);
+  _translucent.push_back(isTranslucent);
+  return (int)_regions.size() - 1;
+}
+
+bool TextureAtlas::Build(SDL_Renderer *renderer)
+{
+  if (_surface == nullptr)
+  {
+    return _texture != nullptr;
+  }
+
+  _texture = SDL_CreateTextureFromSurface(renderer, _surface);
+  if (_texture == nullptr)
+  {
+    printf("SDL_CreateTextureFromSurface: %s\n", SDL_GetError());
+    return false;
+  }
+
+  SDL_SetTextureBlendMode(_texture, SDL_BLENDMODE_BLEND);
+
+  // The pixels live on the GPU now, the staging copy is no longer needed.
+  SDL_FreeSurface(_surface);
+  _surface = nullptr;
+
+  return true;
+}
+
+SDL_Texture* TextureAtlas::GetTexture() const
+{
+  return _texture;
+}
+
+const SDL_Rect& TextureAtlas::GetRegion(int index) const
+{
+  return _regions[index];
+}
+
+int TextureAtlas::GetRegionCount() const
+{
+  return (int)_regions.size();
+}
+
+bool TextureAtlas::IsTranslucent(int index) const
+{
+  return _translucent[index];
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+/**
+ * \class TextureAtlas
+ * \brief Packs images loaded through SDL_image into one texture so sprites can share a single bind.
+ */
+
+#pragma once
+#include <SDL_rect.h>
+#include <vector>
+
+struct SDL_Renderer;
+struct SDL_Surface;
+struct SDL_Texture;
+
+class TextureAtlas
+{
+public:
+  /**
+  * \fn TextureAtlas::TextureAtlas(int width, int height)
+  * \brief Creates an empty atlas with the given page size.
+  * \param width The width of the atlas page in pixels.
+  * \param height The height of the atlas page in pixels.
+  */
+  TextureAtlas(int width, int height);
+
+  /**
+  * \fn TextureAtlas::~TextureAtlas()
+  * \brief Frees the staging surface and the atlas texture.
+  */
+  ~TextureAtlas();
+
+  /**
+  * \fn int TextureAtlas::AddImage(const char *path)
+  * \brief Loads an image with SDL_image and packs it into the next free shelf of the atlas.
+  * \param path The path of the image to load.
+  * \return The region index of the packed image, -1 if it could not be loaded or does not fit.
+  */
+  int AddImage(const char *path);
+
+  /**
+  * \fn bool TextureAtlas::Build(SDL_Renderer *renderer)
+  * \brief Uploads the packed images as a single texture. No more images can be added afterwards.
+  * \param renderer The renderer that will draw from this atlas.
+  * \return Whether or not the texture was created (true/false).
+  */
+  bool Build(SDL_Renderer *renderer);
+
+  /**
+  * \fn SDL_Texture* TextureAtlas::GetTexture() const
+  * \brief Gets the atlas texture, NULL until Build has been called.
+  */
+  SDL_Texture* GetTexture() const;
+
+  /**
+  * \fn const SDL_Rect& TextureAtlas::GetRegion(int index) const
+  * \brief Gets the source rectangle of a packed image.
+  * \param index The region index returned by AddImage.
+  */
+  const SDL_Rect& GetRegion(int index) const;
+
+  /**
+  * \fn int TextureAtlas::GetRegionCount() const
+  * \brief Gets the number of images packed into this atlas.
+  */
+  int GetRegionCount() const;
+
+  /**
+  * \fn bool TextureAtlas::IsTranslucent(int index) const
+  * \brief Gets whether a packed image has pixels that are neither fully opaque nor fully transparent.
+  * \param index The region index returned by AddImage.
+  */
+  bool IsTranslucent(int index) const;
+
+protected:
+  // Images are blitted here until Build uploads them.
+  SDL_Surface *_surface;
+  SDL_Texture *_texture;
+
+  std::vector<SDL_Rect> _regions;
+  std::vector<bool> _translucent;
+
+  int _width, _height;
+
+  // Simple shelf packer: images are placed left to right, a new shelf starts when a row is full.
+  int _shelfX, _shelfY, _shelfHeight;
+};
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "ThreadPool.h"
+#include <SDL_cpuinfo.h>
+
+ThreadPool::ThreadPool(int threadCount) :
+_isStopping(false)
+{
+  if (threadCount <= 0)
+  {
+    threadCount = SDL_GetCPUCount() - 1;
+    if (threadCount < 1)
+    {
+      threadCount = 1;
+    }
+  }
+
+  _workers.reserve(threadCount);
+  for (int i = 0; i < threadCount; i++)
+  {
+    _workers.push_back(std::thread(&ThreadPool::WorkerLoop, this));
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _isStopping = true;
+  }
+  _jobAvailable.notify_all();
+
+  for (auto itr = _workers.begin(); itr != _workers.end(); itr++)
+  {
+    itr->join();
+  }
+}
+
+int ThreadPool::GetThreadCount() const
+{
+  return (int)_workers.size();
+}
+
+void ThreadPool::Enqueue(const std::function<void()> &job)
+{
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _jobs.push_back(job);
+  }
+  _jobAvailable.notify_one();
+}
+
+void ThreadPool::WorkerLoop()
+{
+  while (true)
+  {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      while (_jobs.empty() && _isStopping == false)
+      {
+        _jobAvailable.wait(lock);
+      }
+
+      // Only stop once the queue has run dry, so no submitted future is left without a result.
+      if (_jobs.empty())
+      {
+        return;
+      }
+
+      job = _jobs.front();
+      _jobs.pop_front();
+    }
+
+    job();
+  }
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+/**
+ * \class ThreadPool
+ * \brief A fixed set of worker threads that run submitted jobs in submission order.
+ *
+ * Submit returns a std::future for the job's result, so the caller can poll it from the game loop
+ * (wait_for with a zero timeout) instead of blocking. Destroying the pool runs every job still queued
+ * before joining the workers.
+ */
+
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+class ThreadPool
+{
+public:
+  /**
+  * \fn ThreadPool::ThreadPool(int threadCount)
+  * \brief Starts the worker threads.
+  * \param threadCount The number of workers, 0 for one per CPU core besides the one running the game loop.
+  */
+  explicit ThreadPool(int threadCount = 0);
+
+  /**
+  * \fn ThreadPool::~ThreadPool()
+  * \brief Finishes every queued job and joins the workers.
+  */
+  ~ThreadPool();
+
+  /**
+  * \fn std::future<Result> ThreadPool::Submit(Function function)
+  * \brief Queues a job.
+  * \param function Anything callable without arguments. It runs on a worker thread.
+  * \return A future that receives the job's return value, or the exception it threw.
+  */
+  template <typename Function>
+  std::future<typename std::result_of<Function()>::type> Submit(Function function)
+  {
+    typedef typename std::result_of<Function()>::type Result;
+
+    // std::function needs a copyable target, so the move-only task is shared with the job wrapping it.
+    std::shared_ptr<std::packaged_task<Result()> > task = std::make_shared<std::packaged_task<Result()> >(function);
+    std::future<Result> result = task->get_future();
+    Enqueue([task]() { (*task)(); });
+    return result;
+  }
+
+  int GetThreadCount() const;
+
+protected:
+  void Enqueue(const std::function<void()> &job);
+  void WorkerLoop();
+
+  std::vector<std::thread> _workers;
+  std::deque<std::function<void()> > _jobs;
+  std::mutex _mutex;
+  std::condition_variable _jobAvailable;
+  bool _isStopping;
+};
\ No newline at end of file
@@ -1,7 +1,10 @@
 #include "Cube.h"
-#include <SDL_opengl.h>
 #include <iostream>
 #include <InputManager.h>
+#include <Graphics.h>
+#include <CookedFormats.h>
+#include <ResourceManager.h>
+#include <string.h>
 
 struct Vertex
 {
@@ -29,9 +32,11 @@ void Cube::Initialize(Graphics *graphics)
 {
   size = 0;
 
-  //vertices = new Vertex[8]();
-  vertices = new Vector3[8]();
-  colours = new Vector4[8]();
+  //the cooked mesh is used when the game runs from a packed archive, the built in one from loose files
+  if (LoadCookedMesh("res/cube.mesh"))
+  {
+    return;
+  }
 
   SetVertex(0, /*pos*/-0.5f, 0.5f, 0.5f,  /*color*/ 1.0f, 0.0f, 0.0f, 1.0f);
   SetVertex(1, /*pos*/0.5f, 0.5f, 0.5f,   /*color*/ 1.0f, 1.0f, 0.0f, 1.0f);
@@ -42,11 +47,6 @@ void Cube::Initialize(Graphics *graphics)
   SetVertex(6, /*pos*/-0.5f, -0.5f, -0.5f,/*color*/ 0.0f, 0.0f, 1.0f, 1.0f);
   SetVertex(7, /*pos*/0.5f, -0.5f, -0.5f, /*color*/ 0.0f, 0.0f, 1.0f, 1.0f);
 
-  indices = new unsigned int[30];
-
-  glFrontFace(GL_CW);
-  glCullFace(GL_BACK);
-
   // front
   indices[0] = 0;
   indices[1] = 1;
@@ -102,41 +102,52 @@ void Cube::Initialize(Graphics *graphics)
   indices[35] = 6;
 }
 
+bool Cube::LoadCookedMesh(const char *path)
+{
+  const PackedArchive &archive = ResourceManager::GetInstance()->GetArchive();
+  const ArchiveEntry *entry = archive.Find(path);
+  if (entry == nullptr)
+  {
+    return false;
+  }
+
+  std::vector<Uint8> buffer;
+  const Uint8 *data = archive.GetData(entry, buffer);
+  const CookedMeshHeader *header = (const CookedMeshHeader *)data;
+  size_t expectedSize = sizeof(CookedMeshHeader) + 8 * sizeof(Vector3) + 8 * sizeof(Vector4) + 36 * sizeof(unsigned int);
+  if (data == nullptr || entry->size != expectedSize || header->magic != kCookedMeshMagic ||
+    header->vertexCount != 8 || header->indexCount != 36)
+  {
+    printf("Cube: %s is not a cooked cube mesh\n", path);
+    return false;
+  }
+
+  //the arrays are stored exactly as they are drawn
+  const Uint8 *arrays = data + sizeof(CookedMeshHeader);
+  memcpy(vertices, arrays, 8 * sizeof(Vector3));
+  memcpy(colours, arrays + 8 * sizeof(Vector3), 8 * sizeof(Vector4));
+  memcpy(indices, arrays + 8 * sizeof(Vector3) + 8 * sizeof(Vector4), 36 * sizeof(unsigned int));
+  return true;
+}
+
 void Cube::Update(float dt)
 {
 }
 
 void Cube::Draw(Graphics *graphics, Matrix4x4 relativeTo, float dt)
 { 
-  GLenum error = glGetError();
+  graphics->PushMatrix();
+  graphics->Translate(_transform.position.x, _transform.position.y, _transform.position.z);
+  graphics->Rotate(_transform.rotation.x, 1.0f, 0.0f, 0.0f);
+  graphics->Rotate(_transform.rotation.y, 0.0f, 1.0f, 0.0f);
+  graphics->Rotate(_transform.rotation.z, 0.0f, 0.0f, 1.0f);
 
-  glEnableClientState(GL_VERTEX_ARRAY);
-  glEnableClientState(GL_COLOR_ARRAY);
-  glEnableClientState(GL_INDEX_ARRAY);
-
-  glPushMatrix();
-  glTranslatef(_transform.position.x, _transform.position.y, _transform.position.z);
-  glRotatef(_transform.rotation.x, 1.0f, 0.0f, 0.0f);
-  glRotatef(_transform.rotation.y, 0.0f, 1.0f, 0.0f);
-  glRotatef(_transform.rotation.z, 0.0f, 0.0f, 1.0f);
-
-  glScalef(_transform.scale.x, _transform.scale.y, _transform.scale.z);
-
-  glVertexPointer(3, GL_FLOAT, 0, vertices);
-  //glVertexPointer(3, GL_FLOAT, sizeof(Vertex), vertices);
-
-  glColorPointer(4, GL_FLOAT, 0, colours);
-  //glColorPointer(4, GL_FLOAT, sizeof(Vertex), vertices + sizeof(Vector3));
+  graphics->Scale(_transform.scale.x, _transform.scale.y, _transform.scale.z);
 
   int indexCount = sizeof(indices) / sizeof(unsigned int);
-  indexCount = 30;
-  glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, indices);
-
-  glPopMatrix();
+  graphics->DrawTriangles(vertices, colours, 8, indices, indexCount);
 
-  glDisableClientState(GL_VERTEX_ARRAY);
-  glDisableClientState(GL_COLOR_ARRAY);
-  glDisableClientState(GL_INDEX_ARRAY);
+  graphics->PopMatrix();
 }
 
 void Cube::SetVertex(int index, float x, float y, float z, float r, float g, float b, float a)
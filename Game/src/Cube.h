@@ -64,16 +64,25 @@ public:
 	void SetVertex(int index, float x, float y, float z, float r, float g, float b, float a);
 
 protected:
+	/**
+	* \fn bool Cube::LoadCookedMesh(const char *path)
+	* \brief A function that copies the cube's vertices, colours and indices from a mesh cooked into the mounted archive
+	* \param path the path the mesh was cooked under
+	* \return true if the archive holds a cooked 8 vertex, 36 index mesh at that path, false if not
+	*/
+	bool LoadCookedMesh(const char *path);
+
 	//void *_vertexPointer;
 
-	Vector3 *vertices;
-	Vector4 *colours;
+	//stored inline so cubes can live by value in a Grid
+	Vector3 vertices[8];
+	Vector4 colours[8];
 
 	int size;
 	int offset;
 
 	//Vertex *vertices;
-	unsigned int* indices;
+	unsigned int indices[36];
 
 
 };
\ No newline at end of file
@@ -0,0 +1,289 @@
+#include "EnemySwarm.h"
+#include <Graphics.h>
+#include <GridOccupancy.h>
+#include <GridPathfinder.h>
+
+//corner offsets of a unit cube, same order as the Cube vertices
+static const float kCorners[8][3] =
+{
+	{ -0.5f, 0.5f, 0.5f },
+	{ 0.5f, 0.5f, 0.5f },
+	{ -0.5f, -0.5f, 0.5f },
+	{ 0.5f, -0.5f, 0.5f },
+	{ -0.5f, 0.5f, -0.5f },
+	{ 0.5f, 0.5f, -0.5f },
+	{ -0.5f, -0.5f, -0.5f },
+	{ 0.5f, -0.5f, -0.5f }
+};
+
+//the Cube triangles, clockwise
+static const unsigned int kCubeIndices[36] =
+{
+	0, 1, 2, 1, 3, 2,
+	1, 5, 3, 5, 7, 3,
+	5, 4, 7, 4, 6, 7,
+	4, 0, 6, 6, 0, 2,
+	4, 5, 0, 5, 1, 0,
+	2, 3, 6, 3, 7, 6
+};
+
+EnemySwarm::EnemySwarm() :
+_isMeshDirty(true)
+{
+}
+
+void EnemySwarm::Initialize(int capacity)
+{
+	_gridX.assign(capacity, 0);
+	_gridZ.assign(capacity, 0);
+	_alive.assign(capacity, 0);
+	_chasers.assign(capacity, 0);
+	_moveTimers.assign(capacity, 0.0f);
+	_moving.assign(capacity, 0);
+	_stepsX.assign(capacity, 0);
+	_stepsZ.assign(capacity, 0);
+	_coins.assign((capacity + 31) / 32, 0);
+
+	//lowest indices get used first
+	_deadSlots.clear();
+	for (int i = capacity - 1; i >= 0; i--)
+	{
+		_deadSlots.push_back(i);
+	}
+
+	_positions.reserve(capacity * 8);
+	_colours.reserve(capacity * 8);
+	_indices.reserve(capacity * 36);
+	_isMeshDirty = true;
+}
+
+void EnemySwarm::Seed(Uint64 seed, Uint32 stream)
+{
+	_random.Seed(seed, stream);
+}
+
+int EnemySwarm::Spawn(int gridX, int gridZ, float moveInterval, bool isChaser)
+{
+	if (_deadSlots.empty())
+	{
+		return -1;
+	}
+
+	int index = _deadSlots.back();
+	_deadSlots.pop_back();
+
+	_gridX[index] = gridX;
+	_gridZ[index] = gridZ;
+	_alive[index] = 1;
+	_chasers[index] = isChaser ? 1 : 0;
+	_moveTimers[index] = moveInterval;
+	_isMeshDirty = true;
+	return index;
+}
+
+void EnemySwarm::Kill(int index)
+{
+	if (_alive[index] == 0)
+	{
+		return;
+	}
+
+	_alive[index] = 0;
+	_deadSlots.push_back(index);
+	_isMeshDirty = true;
+}
+
+int EnemySwarm::Update(float dt, float moveInterval, GridOccupancy &occupancy, const FlowField &chase)
+{
+	int count = (int)_alive.size();
+	if (count == (int)_deadSlots.size())
+	{
+		return 0;
+	}
+
+	//pass 1, run the timers down and flag the live enemies whose timer ran out
+	for (int i = 0; i < count; i++)
+	{
+		_moveTimers[i] -= dt;
+		_moving[i] = _alive[i] & (Uint8)(_moveTimers[i] <= 0.0f);
+	}
+
+	//pass 2, a coin flip per enemy picks the axis it steps along, stepping down the staircase is implied by the grid.
+	//every bit of a random number is a coin, so one bulk draw covers 32 enemies
+	_random.Fill(&_coins[0], (int)_coins.size());
+	for (int i = 0; i < count; i++)
+	{
+		Sint32 alongX = (Sint32)((_coins[i >> 5] >> (i & 31)) & 1);
+		_stepsX[i] = alongX;
+		_stepsZ[i] = alongX ^ 1;
+	}
+
+	//chasers step along the flow field instead, one lookup each however many there are
+	for (int i = 0; i < count; i++)
+	{
+		if ((_chasers[i] & _moving[i]) != 0)
+		{
+			chase.GetStep(_gridX[i], _gridZ[i], _stepsX[i], _stepsZ[i]);
+		}
+	}
+
+	//pass 3, step and rewind the timers without branching
+	for (int i = 0; i < count; i++)
+	{
+		Sint32 moving = _moving[i];
+		_gridX[i] += moving * _stepsX[i];
+		_gridZ[i] += moving * _stepsZ[i];
+		_moveTimers[i] += moving * moveInterval;
+	}
+
+	//pass 4, only the enemies that moved touch the occupancy grid, the ones that fell off die
+	int moved = 0;
+	for (int i = 0; i < count; i++)
+	{
+		if (_moving[i] == 0)
+		{
+			continue;
+		}
+
+		moved++;
+		if (occupancy.Move(i, _gridX[i], _gridZ[i]) == false)
+		{
+			Kill(i);
+		}
+	}
+
+	_isMeshDirty |= moved > 0;
+	return moved;
+}
+
+void EnemySwarm::Place(GridOccupancy &occupancy)
+{
+	for (int i = 0; i < (int)_alive.size(); i++)
+	{
+		if (_alive[i] != 0 && occupancy.Insert(i, _gridX[i], _gridZ[i]) == false)
+		{
+			Kill(i);
+		}
+	}
+}
+
+void EnemySwarm::Draw(Graphics *graphics)
+{
+	if (_isMeshDirty)
+	{
+		RebuildMesh();
+	}
+
+	if (_indices.empty())
+	{
+		return;
+	}
+
+	graphics->DrawTriangles(&_positions[0], &_colours[0], _positions.size(), &_indices[0], _indices.size());
+}
+
+void EnemySwarm::Save(Snapshot &snapshot) const
+{
+	snapshot.WriteVector(_gridX);
+	snapshot.WriteVector(_gridZ);
+	snapshot.WriteVector(_alive);
+	snapshot.WriteVector(_chasers);
+	snapshot.WriteVector(_moveTimers);
+	snapshot.WriteVector(_deadSlots);
+	_random.Save(snapshot);
+}
+
+bool EnemySwarm::Restore(Snapshot &snapshot)
+{
+	_isMeshDirty = true;
+	if ((snapshot.ReadVector(_gridX) && snapshot.ReadVector(_gridZ) && snapshot.ReadVector(_alive) &&
+		snapshot.ReadVector(_chasers) && snapshot.ReadVector(_moveTimers) && snapshot.ReadVector(_deadSlots) &&
+		_random.Restore(snapshot)) == false)
+	{
+		return false;
+	}
+
+	//the scratch arrays follow the capacity
+	_moving.resize(_alive.size());
+	_stepsX.resize(_alive.size());
+	_stepsZ.resize(_alive.size());
+	_coins.resize((_alive.size() + 31) / 32);
+	return true;
+}
+
+int EnemySwarm::GetCapacity() const
+{
+	return (int)_alive.size();
+}
+
+int EnemySwarm::GetAliveCount() const
+{
+	return (int)(_alive.size() - _deadSlots.size());
+}
+
+bool EnemySwarm::IsAlive(int index) const
+{
+	return _alive[index] != 0;
+}
+
+bool EnemySwarm::IsChaser(int index) const
+{
+	return _chasers[index] != 0;
+}
+
+int EnemySwarm::GetChaserCount() const
+{
+	int count = 0;
+	for (int i = 0; i < (int)_alive.size(); i++)
+	{
+		count += _alive[i] & _chasers[i];
+	}
+	return count;
+}
+
+int EnemySwarm::GetGridX(int index) const
+{
+	return _gridX[index];
+}
+
+int EnemySwarm::GetGridZ(int index) const
+{
+	return _gridZ[index];
+}
+
+void EnemySwarm::RebuildMesh()
+{
+	_positions.clear();
+	_colours.clear();
+	_indices.clear();
+
+	//wanderers are black, chasers red so the player can tell them apart
+	const Vector4 wandererColour(0.0f, 0.0f, 0.0f, 1.0f);
+	const Vector4 chaserColour(0.8f, 0.0f, 0.0f, 1.0f);
+
+	for (int i = 0; i < (int)_alive.size(); i++)
+	{
+		if (_alive[i] == 0)
+		{
+			continue;
+		}
+
+		//enemies sit one above the tile they are on, the grid is laid out as a staircase
+		float worldX = (float)_gridX[i];
+		float worldY = (float)(1 - (_gridX[i] + _gridZ[i]));
+		float worldZ = (float)_gridZ[i];
+
+		unsigned int firstVertex = _positions.size();
+		for (int corner = 0; corner < 8; corner++)
+		{
+			_positions.push_back(Vector3(worldX + kCorners[corner][0], worldY + kCorners[corner][1], worldZ + kCorners[corner][2]));
+			_colours.push_back((_chasers[i] != 0) ? chaserColour : wandererColour);
+		}
+
+		for (int index = 0; index < 36; index++)
+		{
+			_indices.push_back(firstVertex + kCubeIndices[index]);
+		}
+	}
+	_isMeshDirty = false;
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+/**
+* \class EnemySwarm.h
+* \brief A class that simulates and draws every enemy at once, with the enemy data stored as parallel arrays
+*/
+#pragma once
+
+#include <SDL_stdinc.h>
+#include <MathUtils.h>
+#include <Random.h>
+#include <Snapshot.h>
+#include <vector>
+
+class Graphics;
+class GridOccupancy;
+class FlowField;
+
+class EnemySwarm
+{
+public:
+	/**
+	* \fn EnemySwarm::EnemySwarm()
+	* \brief Default Constructor
+	*/
+	EnemySwarm();
+
+	/**
+	* \fn void EnemySwarm::Initialize(int capacity)
+	* \brief A function that allocates room for the given number of enemies, all of them dead
+	* \param capacity the most enemies that can be alive at once
+	*/
+	void Initialize(int capacity);
+
+	/**
+	* \fn void EnemySwarm::Seed(Uint64 seed, Uint32 stream)
+	* \brief A function that restarts the swarm's own random sequence, the coin flips of the wandering enemies
+	* \param seed, stream where the sequence starts, see Random::Seed
+	*/
+	void Seed(Uint64 seed, Uint32 stream);
+
+	/**
+	* \fn int EnemySwarm::Spawn(int gridX, int gridZ, float moveInterval, bool isChaser)
+	* \brief A function that brings a dead enemy to life on the given tile
+	* \param gridX the tile row
+	* \param gridZ the tile column
+	* \param moveInterval seconds until the enemy takes its first step
+	* \param isChaser true for an enemy that follows the player's flow field instead of rolling down the staircase
+	* \return the index of the enemy, -1 if every enemy is already alive
+	*/
+	int Spawn(int gridX, int gridZ, float moveInterval, bool isChaser);
+
+	/**
+	* \fn void EnemySwarm::Kill(int index)
+	* \brief A function that kills an enemy, it has to be taken off the occupancy grid separately
+	* \param index the enemy
+	*/
+	void Kill(int index);
+
+	/**
+	* \fn int EnemySwarm::Update(float dt, float moveInterval, GridOccupancy &occupancy, const FlowField &chase)
+	* \brief A function that steps every enemy whose timer ran out one tile, down the staircase randomly along x or z
+	* or, for chasers, along the flow field. Enemies that fall off the grid die. Runs as a few passes over whole arrays.
+	* \param dt the time in seconds since the last game tick
+	* \param moveInterval seconds between two steps of an enemy
+	* \param occupancy the grid the enemies are tracked on, moved enemies are moved on it and dead ones removed
+	* \param chase the field chasers follow, shared by all of them
+	* \return the number of enemies that moved
+	*/
+	int Update(float dt, float moveInterval, GridOccupancy &occupancy, const FlowField &chase);
+
+	/**
+	* \fn void EnemySwarm::Place(GridOccupancy &occupancy)
+	* \brief A function that puts every live enemy on a freshly resized occupancy grid, killing the ones outside it
+	* \param occupancy the grid to fill
+	*/
+	void Place(GridOccupancy &occupancy);
+
+	/**
+	* \fn void EnemySwarm::Draw(Graphics *graphics)
+	* \brief A function that draws every live enemy with a single call, the merged mesh is only rebuilt after changes
+	* \param graphics The Graphics object used to draw the game.
+	*/
+	void Draw(Graphics *graphics);
+
+	/**
+	* \fn void EnemySwarm::Save(Snapshot &snapshot) const
+	* \brief A function that appends every enemy array to a snapshot, each as a single copy
+	* \param snapshot the snapshot to write to
+	*/
+	void Save(Snapshot &snapshot) const;
+
+	/**
+	* \fn bool EnemySwarm::Restore(Snapshot &snapshot)
+	* \brief A function that reads back what Save wrote, the merged mesh is rebuilt on the next draw
+	* \param snapshot the snapshot to read from
+	* \return false if the snapshot ran out
+	*/
+	bool Restore(Snapshot &snapshot);
+
+	int GetCapacity() const;
+	int GetAliveCount() const;
+	bool IsAlive(int index) const;
+	bool IsChaser(int index) const;
+	int GetChaserCount() const;
+	int GetGridX(int index) const;
+	int GetGridZ(int index) const;
+
+protected:
+	/**
+	* \fn void EnemySwarm::RebuildMesh()
+	* \brief A function that regenerates the merged cube mesh of the live enemies
+	*/
+	void RebuildMesh();
+
+	//one entry per enemy, alive or not
+	std::vector<Sint32> _gridX;
+	std::vector<Sint32> _gridZ;
+	std::vector<Uint8> _alive;
+	std::vector<Uint8> _chasers;
+	std::vector<float> _moveTimers;
+
+	//per pass scratch, kept to avoid allocating every tick
+	std::vector<Uint8> _moving;
+	std::vector<Sint32> _stepsX;
+	std::vector<Sint32> _stepsZ;
+	std::vector<Uint32> _coins;
+
+	//indices of the dead enemies, used as a stack by Spawn
+	std::vector<int> _deadSlots;
+
+	//the coin flips, drawn 32 to a number
+	Random _random;
+
+	//merged mesh of the live enemies
+	std::vector<Vector3> _positions;
+	std::vector<Vector4> _colours;
+	std::vector<unsigned int> _indices;
+	bool _isMeshDirty;
+};
\ No newline at end of file
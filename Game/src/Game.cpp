@@ -3,16 +3,45 @@
 #include <SDL.h>
 #include <math.h>
 #include <SDL_image.h>
-#include <SDL_opengl.h>
+#include <Graphics.h>
 #include <InputManager.h>
+#include <AssetLoader.h>
+#include <AudioManager.h>
+#include <ResourceManager.h>
+#include <SDL_mixer.h>
 
 #include "Cube.h"
-#include "Enemy.h"
+#include "WorldMesh.h"
 #include <Cameras/Camera.h>
 #include <Cameras/PerspectiveCamera.h>
 #include <Cameras/OrthographicCamera.h>
 #include <Windows.h>
-#include <time.h>
+
+//corner colours of a tile the player hasn't visited yet, same as the Cube defaults
+static const Vector4 kUnvisitedTileColours[8] =
+{
+	Vector4(1.0f, 0.0f, 0.0f, 1.0f),
+	Vector4(1.0f, 1.0f, 0.0f, 1.0f),
+	Vector4(1.0f, 0.0f, 1.0f, 1.0f),
+	Vector4(0.0f, 1.0f, 0.0f, 1.0f),
+	Vector4(0.0f, 0.0f, 1.0f, 1.0f),
+	Vector4(0.0f, 0.0f, 1.0f, 1.0f),
+	Vector4(0.0f, 0.0f, 1.0f, 1.0f),
+	Vector4(0.0f, 0.0f, 1.0f, 1.0f)
+};
+
+//corner colours of a tile the player has visited
+static const Vector4 kVisitedTileColours[8] =
+{
+	Vector4(1.0f, 1.0f, 0.0f, 1.0f),
+	Vector4(1.0f, 0.0f, 1.0f, 1.0f),
+	Vector4(1.0f, 0.0f, 0.0f, 1.0f),
+	Vector4(1.0f, 1.0f, 0.0f, 1.0f),
+	Vector4(0.0f, 0.0f, 1.0f, 1.0f),
+	Vector4(1.0f, 1.0f, 0.0f, 1.0f),
+	Vector4(0.0f, 0.0f, 1.0f, 1.0f),
+	Vector4(1.0f, 1.0f, 0.0f, 1.0f)
+};
 
 // Initializing our static member pointer.
 GameEngine* GameEngine::_instance = nullptr;
@@ -34,62 +63,48 @@ Game::Game() : GameEngine()
 Game::~Game()
 {
 	delete(_playerCube);
-	//free visited cubes memory
-	for (int i = 0; i < _gridHeight; i++)
-	{
-		free(_visitedCubes[i]);
-	}
-	free(_visitedCubes);
-	for (int i = 0; i < _gridHeight; i++)
-	{
-		delete[](_worldCubes[i]);
-	}
-	delete[](_worldCubes);
-	delete[](_enemies);
-	Mix_FreeChunk(_moveSound);
-	Mix_FreeChunk(_dieSound);
-	Mix_FreeChunk(_clearLevelSound);
-	Mix_FreeChunk(_visitedNewBlockSound);
-	Mix_FreeChunk(_enemySpawnSound);
-	Mix_FreeChunk(_enemyMovementSound);
-	Mix_CloseAudio();
-	Mix_Quit();
+	delete(_worldMesh);
 	free(_windowString);
 }
 
-void Game::InitializeImpl(Graphics *graphics)
+GameSimulation* Game::GetSimulation()
 {
-	srand(time(NULL));
-
-	//initialize array of enemies
-	_numEnemies = 10;
-
-	_enemyDeployRate = 5;//deploy every 5 seconds
-
-	_enemyMovementSpeed = 1;//move down every second
-
-	_enemies = new Enemy[_numEnemies]();
-	for (int i = 0; i < _numEnemies; i++)
-	{
-		_enemies[i].Initialize(graphics);
-		_enemies[i].GetTransform().position = Vector3(0, 0, 0);
-	}
+	return &_simulation;
+}
 
-	//set too zero since no enemies have spawned yet
-	_timeSinceLastEnemySpawn = 0;
-	_timeSinceLastEnemyMoveMent = 0;
+void Game::SetStartingGridSize(int size)
+{
+	_simulation.SetStartingGridSize(size);
+}
 
-	//set player starting score and lives
-	_playerScore = 0;
-	_playerLives = 5;
+void Game::SetEnemyCapacity(int capacity)
+{
+	_simulation.SetEnemyCapacity(capacity);
+}
 
-	//initial player game grid position
-	_playerGridPos.x = 0;
-	_playerGridPos.y = 0;
+void Game::SetActiveChunkRadius(int radius)
+{
+	_simulation.SetActiveChunkRadius(radius);
+}
 
-	//set initial window title
-	sprintf_s(_windowString, 80, "Cubert   Score: %d   Lives: %d", _playerScore, _playerLives);
-	SDL_SetWindowTitle(_window, _windowString);
+void Game::InitializeImpl(Graphics *graphics)
+{
+	//player movement, arrow keys or WASD
+	_actions.Bind(ACTION_MOVE_UP, SDL_SCANCODE_UP);
+	_actions.Bind(ACTION_MOVE_UP, SDL_SCANCODE_W);
+	_actions.Bind(ACTION_MOVE_DOWN, SDL_SCANCODE_DOWN);
+	_actions.Bind(ACTION_MOVE_DOWN, SDL_SCANCODE_S);
+	_actions.Bind(ACTION_MOVE_LEFT, SDL_SCANCODE_LEFT);
+	_actions.Bind(ACTION_MOVE_LEFT, SDL_SCANCODE_A);
+	_actions.Bind(ACTION_MOVE_RIGHT, SDL_SCANCODE_RIGHT);
+	_actions.Bind(ACTION_MOVE_RIGHT, SDL_SCANCODE_D);
+
+	//stamp input when it arrives, the engine also samples before the buffer swap
+	InputManager::GetInstance()->EnableSampling();
+
+	//assets come from the packed archive when one was cooked, loose files in res/ otherwise, mounted before
+	//anything is loaded so the player cube finds its cooked mesh
+	ResourceManager::GetInstance()->MountArchive("res.pak");
 
 	//initialize player
 	_playerCube = new Cube();
@@ -104,67 +119,25 @@ void Game::InitializeImpl(Graphics *graphics)
 	_playerCube->SetVertex(7, /*pos*/0.5f, -0.5f, -0.5f, /*color*/ 1.0f, 1.0f, 0.0f, 1.0f);
 	_playerCube->GetTransform().position = Vector3(0, 1, 0);
 
-	//load audio
-	int channel;
+	//load audio, a higher priority sound can take the voice of a lower priority one
 	Uint16 audio_format = AUDIO_U8;
 	int audio_channels = 2;
 	int audio_buffers = 4096;
-	if (Mix_OpenAudio(MIX_DEFAULT_FREQUENCY, audio_format, audio_channels, audio_buffers) != 0) {
+	int audio_voices = 8;
+	if (AudioManager::GetInstance()->Open(MIX_DEFAULT_FREQUENCY, audio_format, audio_channels, audio_buffers, audio_voices) == false) {
 		printf("Unable to initialize audio: %s\n", Mix_GetError());
 		Sleep(2000);
 		exit(EXIT_FAILURE);
 	}
-	_moveSound = Mix_LoadWAV("res/boing2.wav");
-	if (!_moveSound) {
-		printf("Mix_LoadWAV: %s\n", Mix_GetError());
-		Sleep(2000);
-		exit(EXIT_FAILURE);
-	}
-	_dieSound = Mix_LoadWAV("res/car_crash.wav");
-	if (!_dieSound) {
-		printf("Mix_LoadWAV: %s\n", Mix_GetError());
-		Sleep(2000);
-		exit(EXIT_FAILURE);
-	}
-	_clearLevelSound = Mix_LoadWAV("res/applause.wav");
-	if (!_clearLevelSound) {
-		printf("Mix_LoadWAV: %s\n", Mix_GetError());
-		Sleep(2000);
-		exit(EXIT_FAILURE);
-	}
-	_visitedNewBlockSound = Mix_LoadWAV("res/bottle_x.wav");
-	if (!_visitedNewBlockSound) {
-		printf("Mix_LoadWAV: %s\n", Mix_GetError());
-		Sleep(2000);
-		exit(EXIT_FAILURE);
-	}
-	_enemySpawnSound = Mix_LoadWAV("res/bowling.wav");
-	if (!_enemySpawnSound) {
-		printf("Mix_LoadWAV: %s\n", Mix_GetError());
-		Sleep(2000);
-		exit(EXIT_FAILURE);
-	}
-	_enemyMovementSound = Mix_LoadWAV("res/cannon_x.wav");
-	if (!_enemyMovementSound) {
-		printf("Mix_LoadWAV: %s\n", Mix_GetError());
-		Sleep(2000);
-		exit(EXIT_FAILURE);
-	}
-
-	//initialize world grid
-	_gridHeight = 4;
-	_gridWidth = _gridHeight;
 
-	//create arrays of ints used for boolean logic wether or not cubes have been visited
-	_visitedCubes = (int**)malloc(sizeof(int*)* _gridHeight);
-	for (int i = 0; i < _gridHeight; i++)
-	{
-		_visitedCubes[i] = (int*)malloc(sizeof(int)* _gridWidth);
-		for (int x = 0; x < _gridWidth; x++)
-		{
-			_visitedCubes[i][x] = 0;
-		}
-	}
+	//sounds decode in the background and stay silent until they are ready, a missing file is logged and stays silent
+	AssetLoader *loader = GetAssetLoader();
+	_moveSound = AudioManager::GetInstance()->LoadSoundAsync("res/boing2.wav", 40, 2, loader);
+	_dieSound = AudioManager::GetInstance()->LoadSoundAsync("res/car_crash.wav", 100, 1, loader);
+	_clearLevelSound = AudioManager::GetInstance()->LoadSoundAsync("res/applause.wav", 90, 1, loader);
+	_visitedNewBlockSound = AudioManager::GetInstance()->LoadSoundAsync("res/bottle_x.wav", 50, 2, loader);
+	_enemySpawnSound = AudioManager::GetInstance()->LoadSoundAsync("res/bowling.wav", 60, 1, loader);
+	_enemyMovementSound = AudioManager::GetInstance()->LoadSoundAsync("res/cannon_x.wav", 10, 2, loader);
 
 	//initialize camera
 	float nearPlane = 0.01f;
@@ -176,39 +149,34 @@ void Game::InitializeImpl(Graphics *graphics)
 	//_camera = new PerspectiveCamera(50.0f, 1.0f, nearPlane, farPlane, position, lookAt, up);
 	_camera = new OrthographicCamera(-10.0f, 10.0f, 10.0f, -10.0f, nearPlane, farPlane, position, lookAt, up);
 
+	//the world is drawn as one merged mesh, faces turned away from the camera are left out.
+	//it has to listen to the tiles before the simulation starts, the first chunks load right away
+	ChunkedStateGrid *tiles = _simulation.GetTiles();
+	_worldMesh = new WorldMesh();
+	_worldMesh->SetViewDirection(Vector3(-lookAt.x, -lookAt.y, -lookAt.z));
+	_worldMesh->SetStateColours(GameSimulation::TILE_UNVISITED, kUnvisitedTileColours);
+	_worldMesh->SetStateColours(GameSimulation::TILE_VISITED, kVisitedTileColours);
+	_worldMesh->SetTiles(tiles);
+	tiles->AddListener<WorldMesh, &WorldMesh::OnTileChanged>(_worldMesh);
+	tiles->AddChunkListener<WorldMesh, &WorldMesh::OnChunkChanged>(_worldMesh);
+
+	//sounds and the window title react to the tick's events in one pass per event type, after the simulation's scoring
+	EventBus *events = _simulation.GetEventBus();
+	events->Subscribe<PlayerMovedEvent, Game, &Game::OnPlayerMoved>(this);
+	events->Subscribe<TileVisitedEvent, Game, &Game::OnTilesVisited>(this);
+	events->Subscribe<PlayerDiedEvent, Game, &Game::OnPlayerDied>(this);
+	events->Subscribe<EnemySpawnedEvent, Game, &Game::OnEnemiesSpawned>(this);
+	events->Subscribe<EnemiesMovedEvent, Game, &Game::OnEnemiesMoved>(this);
+	events->Subscribe<LevelClearedEvent, Game, &Game::OnLevelCleared>(this);
+	events->Subscribe<GameResetEvent, Game, &Game::OnGameReset>(this);
+
+	//seeded by the engine so recorded sessions replay identically
+	_simulation.Initialize(GetSeed());
 
-	//initialize 2 dimensional array of world cubes
-
-	//allocate space on the heap to hold pointers to the world cubes
-	_worldCubes = (Cube**)malloc(sizeof(Cube*)* _gridHeight);
-
-	//initialize world cubes
-	int index = 0;
-	for (int gridX = 0; gridX < _gridHeight; gridX++)
-	{
-		_worldCubes[gridX] = new Cube[(int)_gridWidth]();
-		for (int gridZ = 0; gridZ < _gridWidth; gridZ++)
-		{
-			//world coordinates
-			float worldX = gridX;
-			float worldY = -(gridX + gridZ);
-			float worldZ = gridZ;
-
-			_worldCubes[gridX][gridZ].GetTransform().position = Vector3(worldX, worldY, worldZ);
-			_worldCubes[gridX][gridZ].Initialize(graphics);
-			index++;
-		}
-	}
-
-	//set the world cube the player starts on to visited
-	_worldCubes[0][0].SetVertex(0, /*pos*/-0.5f, 0.5f, 0.5f,  /*color*/ 1.0f, 1.0f, 0.0f, 1.0f);
-	_worldCubes[0][0].SetVertex(1, /*pos*/0.5f, 0.5f, 0.5f,   /*color*/ 1.0f, 0.0f, 1.0f, 1.0f);
-	_worldCubes[0][0].SetVertex(2, /*pos*/-0.5f, -0.5f, 0.5f, /*color*/ 1.0f, 0.0f, 0.0f, 1.0f);
-	_worldCubes[0][0].SetVertex(3, /*pos*/0.5f, -0.5f, 0.5f,  /*color*/ 1.0f, 1.0f, 0.0f, 1.0f);
-	_worldCubes[0][0].SetVertex(4, /*pos*/-0.5f, 0.5f, -0.5f, /*color*/ 0.0f, 0.0f, 1.0f, 1.0f);
-	_worldCubes[0][0].SetVertex(5, /*pos*/0.5f, 0.5f, -0.5f,  /*color*/ 1.0f, 1.0f, 0.0f, 1.0f);
-	_worldCubes[0][0].SetVertex(6, /*pos*/-0.5f, -0.5f, -0.5f,/*color*/ 0.0f, 0.0f, 1.0f, 1.0f);
-	_worldCubes[0][0].SetVertex(7, /*pos*/0.5f, -0.5f, -0.5f, /*color*/ 1.0f, 1.0f, 0.0f, 1.0f);
+	//set initial window title
+	sprintf_s(_windowString, 80, "Cubert   Score: %d   Lives: %d", _simulation.GetScore(), _simulation.GetLives());
+	SDL_SetWindowTitle(_window, _windowString);
+	_isTitleDirty = false;
 }
 
 void Game::UpdateImpl(Graphics * graphics, float dt)
@@ -219,114 +187,45 @@ void Game::UpdateImpl(Graphics * graphics, float dt)
 	if (timeSinceLastFPS > 0.2f){
 		fps = 1.0f / dt;
 		timeSinceLastFPS = 0;
+		_isTitleDirty = true;
 	}
-	sprintf_s(_windowString, 80, "Cubert   Score: %d   Lives: %d   FPS: %f", _playerScore, _playerLives, fps);
-	SDL_SetWindowTitle(_window, _windowString);
-	if ((_playerGridPos.x < _gridHeight && _playerGridPos.y < _gridWidth) && (_playerGridPos.x > -1 && _playerGridPos.y > -1))
+	if (_isTitleDirty)
+	{
+		sprintf_s(_windowString, 80, "Cubert   Score: %d   Lives: %d   FPS: %f", _simulation.GetScore(), _simulation.GetLives(), fps);
+		SDL_SetWindowTitle(_window, _windowString);
+		_isTitleDirty = false;
+	}
+
+	//the keyboard is only read while the player is on the grid
+	GameSimulation::PlayerMove move = GameSimulation::MOVE_NONE;
+	if (_simulation.IsPlayerOnGrid())
 	{
 		InputManager::GetInstance()->Update(dt);
-		if (InputManager::GetInstance()->GetKeyState(SDLK_UP, SDL_KEYUP) == true)
+		_actions.Resolve(InputManager::GetInstance());
+		if (_actions.WasReleased(ACTION_MOVE_UP) == true)
 		{
-			_playerCube->GetTransform().position.y = _playerCube->GetTransform().position.y + 1;
-			_playerCube->GetTransform().position.z = _playerCube->GetTransform().position.z - 1;
-			_playerGridPos.y--;
-			Mix_PlayChannel(-1, _moveSound, 0);
+			move = GameSimulation::MOVE_UP;
 		}
-		else if (InputManager::GetInstance()->GetKeyState(SDLK_DOWN, SDL_KEYUP) == true)
+		else if (_actions.WasReleased(ACTION_MOVE_DOWN) == true)
 		{
-			_playerCube->GetTransform().position.y = _playerCube->GetTransform().position.y - 1;
-			_playerCube->GetTransform().position.z = _playerCube->GetTransform().position.z + 1;
-			_playerGridPos.y++;
-			Mix_PlayChannel(-1, _moveSound, 0);
+			move = GameSimulation::MOVE_DOWN;
 		}
-		else if (InputManager::GetInstance()->GetKeyState(SDLK_RIGHT, SDL_KEYUP) == true)
+		else if (_actions.WasReleased(ACTION_MOVE_RIGHT) == true)
 		{
-			_playerCube->GetTransform().position.y = _playerCube->GetTransform().position.y - 1;
-			_playerCube->GetTransform().position.x = _playerCube->GetTransform().position.x + 1;
-			_playerGridPos.x++;
-			Mix_PlayChannel(-1, _moveSound, 0);
+			move = GameSimulation::MOVE_RIGHT;
 		}
-		else if (InputManager::GetInstance()->GetKeyState(SDLK_LEFT, SDL_KEYUP) == true)
+		else if (_actions.WasReleased(ACTION_MOVE_LEFT) == true)
 		{
-			_playerCube->GetTransform().position.y = _playerCube->GetTransform().position.y + 1;
-			_playerCube->GetTransform().position.x = _playerCube->GetTransform().position.x - 1;
-			_playerGridPos.x--;
-			Mix_PlayChannel(-1, _moveSound, 0);
+			move = GameSimulation::MOVE_LEFT;
 		}
 	}
-	else
-	{
-		Mix_PlayChannel(-1, _dieSound, 0);
-		_playerLives -= 1;
-		_playerGridPos.x = 0;
-		_playerGridPos.y = 0;
-		_playerCube->GetTransform().position = Vector3(0, 1, 0);
-	}
-
-	//deploy enemies
-	_timeSinceLastEnemySpawn += dt;
-	if (_timeSinceLastEnemySpawn > _enemyDeployRate)
-	{
-		DeployEnemy();
-	}
-
-	//move enemies
-	_timeSinceLastEnemyMoveMent += dt;
-	if (_timeSinceLastEnemyMoveMent > _enemyMovementSpeed)
-	{
-		for (int i = 0; i < _numEnemies; i++)
-		{
-			if (_enemies[i].GetIsAlive() == true)
-			{
-				_enemies[i].MoveDownGameWorld();
-				Mix_PlayChannel(-1, _enemyMovementSound, 0);
-			}
-		}
-		_timeSinceLastEnemyMoveMent = 0;
-	}
-
-	//check if enemies have fallen off
-	for (int i = 0; i < _numEnemies; i++)
-	{
-		if (_enemies[i].GetIsAlive() == true)
-		if (_enemies[i].GetGridPos().x >= _gridHeight || _enemies[i].GetGridPos().y >= _gridWidth)
-			_enemies[i].SetIsAlive(false);
-	}
-
 
-	//update array of enemies
-	for (int i = 0; i < _numEnemies; i++)
-	{
-		if (_enemies[i].GetIsAlive() == true)
-			_enemies[i].Update(dt);
-	}
-
-	//check cubes if they are visited
-	int allVisted = UpdateCubeVisitState();
-	if (allVisted == 1)
-	{
-		NextGameLevel(graphics);
-		allVisted = 0;
-	}
-	
-	//check for player collisions with enemies
-	CheckPlayerEnemyCollisions();
-
-	if (_playerLives < 0)
-	{
-		ResetGame(graphics);
-	}
+	//the tick's events reach the handlers below before this returns
+	_simulation.Update(dt, move);
 
 	//update player
+	_playerCube->GetTransform().position = _simulation.GetPlayerPosition();
 	_playerCube->Update(dt);
-
-	for (int i = 0; i < _gridHeight; i++)
-	{
-		for (int x = 0; x < _gridWidth; x++)
-		{
-			_worldCubes[i][x].Update(dt);
-		}
-	}
 }
 
 void Game::DrawImpl(Graphics *graphics, float dt)
@@ -334,230 +233,25 @@ void Game::DrawImpl(Graphics *graphics, float dt)
 	std::vector<GameObject *> renderOrder = _objects;
 	//CalculateDrawOrder(renderOrder);
 
-	glPushMatrix();
-	glTranslatef(0, 9, 0);
-	CalculateCameraViewpoint();
-
-	_playerCube->Draw(graphics, _camera->GetProjectionMatrix(), dt);
-
-	for (int i = 0; i < _gridHeight; i++)
-	{
-		for (int x = 0; x < _gridWidth; x++)
-		{
-			_worldCubes[i][x].Draw(graphics, _camera->GetProjectionMatrix(), dt);
-		}
-	}
-
-	//draw array of enemies
-	for (int i = 0; i < _numEnemies; i++)
-	{
-		if (_enemies[i].GetIsAlive() == true)
-			_enemies[i].Draw(graphics, _camera->GetProjectionMatrix(), dt);
-	}
-	glPopMatrix();
-}
-
-void Game::NextGameLevel(Graphics *graphics)
-{
-	Mix_PlayChannel(-1, _clearLevelSound, 0);
-	//free visited cubes memory
-	for (int i = 0; i < _gridHeight; i++)
-	{
-		free(_visitedCubes[i]);
-	}
-	free(_visitedCubes);
-
-	//free world cube memory
-	for (int i = 0; i < _gridHeight; i++)
-	{
-		delete[](_worldCubes[i]);
-	}
-	delete[](_worldCubes);
-
-	//increment grid size
-	if (_gridHeight < 9)
-	{
-		_gridHeight++;
-		_gridWidth++;
-	}
-	else{
-		if (_enemyDeployRate > 1)
-		{
-			_enemyDeployRate -= 1;
-		}
-		if (_enemyMovementSpeed > 0.1)
-		{
-			_enemyDeployRate -= 0.1;
-		}
-	}
-
-	//set player game pos to origin
-	_playerGridPos.x = 0;
-	_playerGridPos.y = 0;
-
-	//set player draw pos too start pos
-	_playerCube->GetTransform().position = Vector3(0, 1, 0);
-
-	//create arrays of chars used for bolean logic wether or not cubes have been visited
-	_visitedCubes = (int**)malloc(sizeof(int*)* _gridHeight);
-	for (int i = 0; i < _gridHeight; i++)
-	{
-		_visitedCubes[i] = (int*)malloc(sizeof(int)* _gridWidth);
-		for (int x = 0; x < _gridWidth; x++)
-		{
-			_visitedCubes[i][x] = 0;
-		}
-	}
-
-	//initialize array of world cubes
-
-	//allocate space on the heap to hold pointers to the world cubes
-	_worldCubes = (Cube**)malloc(sizeof(Cube*)* _gridHeight);
-	int index = 0;
-	for (int gridX = 0; gridX < _gridHeight; gridX++)
-	{
-		_worldCubes[gridX] = new Cube[(int)_gridWidth]();
-		for (int gridZ = 0; gridZ < _gridWidth; gridZ++)
-		{
-			//world coordinates
-			float worldX = gridX;
-			float worldY = -(gridX + gridZ);
-			float worldZ = gridZ;
-
-			_worldCubes[gridX][gridZ].GetTransform().position = Vector3(worldX, worldY, worldZ);
-			_worldCubes[gridX][gridZ].Initialize(graphics);
-			index++;
-		}
-	}
-
-	//set the world cube the player starts on to visited
-	_worldCubes[0][0].SetVertex(0, /*pos*/-0.5f, 0.5f, 0.5f,  /*color*/ 1.0f, 1.0f, 0.0f, 1.0f);
-	_worldCubes[0][0].SetVertex(1, /*pos*/0.5f, 0.5f, 0.5f,   /*color*/ 1.0f, 0.0f, 1.0f, 1.0f);
-	_worldCubes[0][0].SetVertex(2, /*pos*/-0.5f, -0.5f, 0.5f, /*color*/ 1.0f, 0.0f, 0.0f, 1.0f);
-	_worldCubes[0][0].SetVertex(3, /*pos*/0.5f, -0.5f, 0.5f,  /*color*/ 1.0f, 1.0f, 0.0f, 1.0f);
-	_worldCubes[0][0].SetVertex(4, /*pos*/-0.5f, 0.5f, -0.5f, /*color*/ 0.0f, 0.0f, 1.0f, 1.0f);
-	_worldCubes[0][0].SetVertex(5, /*pos*/0.5f, 0.5f, -0.5f,  /*color*/ 1.0f, 1.0f, 0.0f, 1.0f);
-	_worldCubes[0][0].SetVertex(6, /*pos*/-0.5f, -0.5f, -0.5f,/*color*/ 0.0f, 0.0f, 1.0f, 1.0f);
-	_worldCubes[0][0].SetVertex(7, /*pos*/0.5f, -0.5f, -0.5f, /*color*/ 1.0f, 1.0f, 0.0f, 1.0f);
-
-	_playerLives++;
-}
-
-void Game::ResetGame(Graphics *graphics)
-{
-	Mix_PlayChannel(-1, _dieSound, 0);
-
-	//reset enemy speeds to default
-	_enemyMovementSpeed = 1;
-	_enemyDeployRate = 5;
-
-	//free visited cubes memory
-	for (int i = 0; i < _gridHeight; i++)
-	{
-		free(_visitedCubes[i]);
-	}
-	free(_visitedCubes);
-
-	//free world cube memory
-	for (int i = 0; i < _gridHeight; i++)
-	{
-		delete[](_worldCubes[i]);
-	}
-	delete[](_worldCubes);
-
-	_gridHeight = 4;
-	_gridWidth = 4;
-
-	//set player game pos to origin
-	_playerGridPos.x = 0;
-	_playerGridPos.y = 0;
-
-	//set player lives and score too default
-	_playerScore = 0;
-	_playerLives = 5;
-
-	//set player draw pos too start pos
-	_playerCube->GetTransform().position = Vector3(0, 1, 0);
-
-	//create arrays of chars used for bolean logic wether or not cubes have been visited
-	_visitedCubes = (int**)malloc(sizeof(int*)* _gridHeight);
-	for (int i = 0; i < _gridHeight; i++)
-	{
-		_visitedCubes[i] = (int*)malloc(sizeof(int)* _gridWidth);
-		for (int x = 0; x < _gridWidth; x++)
-		{
-			_visitedCubes[i][x] = 0;
-		}
-	}
-
-	//initialize array of world cubes
+	graphics->PushMatrix();
+	graphics->Translate(0, 9, 0);
+	CalculateCameraViewpoint(graphics);
 
-	//allocate space on the heap to hold pointers to the world cubes
-	_worldCubes = (Cube**)malloc(sizeof(Cube*)* _gridHeight);
-	int index = 0;
-	for (int gridX = 0; gridX < _gridHeight; gridX++)
+	//bigger levels scroll, the player stays where the middle tile of the largest fixed level would be
+	if (_simulation.GetGridRows() > GameSimulation::kFixedViewSize || _simulation.GetGridColumns() > GameSimulation::kFixedViewSize)
 	{
-		_worldCubes[gridX] = new Cube[(int)_gridWidth]();
-		for (int gridZ = 0; gridZ < _gridWidth; gridZ++)
-		{
-			//world coordinates
-			float worldX = gridX;
-			float worldY = -(gridX + gridZ);
-			float worldZ = gridZ;
-
-			_worldCubes[gridX][gridZ].GetTransform().position = Vector3(worldX, worldY, worldZ);
-			_worldCubes[gridX][gridZ].Initialize(graphics);
-			index++;
-		}
+		float middle = (GameSimulation::kFixedViewSize - 1) * 0.5f;
+		Vector3 player = _playerCube->GetTransform().position;
+		graphics->Translate(middle - player.x, 1 - 2 * middle - player.y, middle - player.z);
 	}
 
-	//set the world cube the player starts on to visited
-	_worldCubes[0][0].SetVertex(0, /*pos*/-0.5f, 0.5f, 0.5f,  /*color*/ 1.0f, 1.0f, 0.0f, 1.0f);
-	_worldCubes[0][0].SetVertex(1, /*pos*/0.5f, 0.5f, 0.5f,   /*color*/ 1.0f, 0.0f, 1.0f, 1.0f);
-	_worldCubes[0][0].SetVertex(2, /*pos*/-0.5f, -0.5f, 0.5f, /*color*/ 1.0f, 0.0f, 0.0f, 1.0f);
-	_worldCubes[0][0].SetVertex(3, /*pos*/0.5f, -0.5f, 0.5f,  /*color*/ 1.0f, 1.0f, 0.0f, 1.0f);
-	_worldCubes[0][0].SetVertex(4, /*pos*/-0.5f, 0.5f, -0.5f, /*color*/ 0.0f, 0.0f, 1.0f, 1.0f);
-	_worldCubes[0][0].SetVertex(5, /*pos*/0.5f, 0.5f, -0.5f,  /*color*/ 1.0f, 1.0f, 0.0f, 1.0f);
-	_worldCubes[0][0].SetVertex(6, /*pos*/-0.5f, -0.5f, -0.5f,/*color*/ 0.0f, 0.0f, 1.0f, 1.0f);
-	_worldCubes[0][0].SetVertex(7, /*pos*/0.5f, -0.5f, -0.5f, /*color*/ 1.0f, 1.0f, 0.0f, 1.0f);
-}
-
-int Game::UpdateCubeVisitState()
-{
-	int gridX, gridY;
+	_playerCube->Draw(graphics, _camera->GetProjectionMatrix(), dt);
 
-	if ((_playerGridPos.x < _gridHeight && _playerGridPos.y < _gridWidth) && (_playerGridPos.x > -1 && _playerGridPos.y > -1))
-	{
-		//if the cubes hasnt been visited already
-		if (_visitedCubes[(int)_playerGridPos.x][(int)_playerGridPos.y] == 0)
-		{
-			_playerScore += 5;
-			_visitedCubes[(int)_playerGridPos.x][(int)_playerGridPos.y] = 1;
-			_worldCubes[(int)_playerGridPos.x][(int)_playerGridPos.y].SetVertex(0, /*pos*/-0.5f, 0.5f, 0.5f,  /*color*/ 1.0f, 1.0f, 0.0f, 1.0f);
-			_worldCubes[(int)_playerGridPos.x][(int)_playerGridPos.y].SetVertex(1, /*pos*/0.5f, 0.5f, 0.5f,   /*color*/ 1.0f, 0.0f, 1.0f, 1.0f);
-			_worldCubes[(int)_playerGridPos.x][(int)_playerGridPos.y].SetVertex(2, /*pos*/-0.5f, -0.5f, 0.5f, /*color*/ 1.0f, 0.0f, 0.0f, 1.0f);
-			_worldCubes[(int)_playerGridPos.x][(int)_playerGridPos.y].SetVertex(3, /*pos*/0.5f, -0.5f, 0.5f,  /*color*/ 1.0f, 1.0f, 0.0f, 1.0f);
-			_worldCubes[(int)_playerGridPos.x][(int)_playerGridPos.y].SetVertex(4, /*pos*/-0.5f, 0.5f, -0.5f, /*color*/ 0.0f, 0.0f, 1.0f, 1.0f);
-			_worldCubes[(int)_playerGridPos.x][(int)_playerGridPos.y].SetVertex(5, /*pos*/0.5f, 0.5f, -0.5f,  /*color*/ 1.0f, 1.0f, 0.0f, 1.0f);
-			_worldCubes[(int)_playerGridPos.x][(int)_playerGridPos.y].SetVertex(6, /*pos*/-0.5f, -0.5f, -0.5f,/*color*/ 0.0f, 0.0f, 1.0f, 1.0f);
-			_worldCubes[(int)_playerGridPos.x][(int)_playerGridPos.y].SetVertex(7, /*pos*/0.5f, -0.5f, -0.5f, /*color*/ 1.0f, 1.0f, 0.0f, 1.0f);
-			Mix_PlayChannel(-1, _visitedNewBlockSound, 0);
-			//printf("Visited X: %d  Y: %d\n", (int)_playerGridPos.x, (int)_playerGridPos.y);
-		}
-	}
+	_worldMesh->Draw(graphics);
 
-	for (gridX = 0; gridX < _gridWidth; gridX++)
-	{
-		for (gridY = 0; gridY < _gridHeight; gridY++)
-		{
-
-			if (_visitedCubes[gridX][gridY] == 0)
-			{
-				return 0;
-			}
-		}
-	}
-	return 1;
+	//draw every enemy at once
+	_simulation.GetEnemies()->Draw(graphics);
+	graphics->PopMatrix();
 }
 
 void Game::CalculateDrawOrder(std::vector<GameObject *>& drawOrder)
@@ -594,7 +288,7 @@ void Game::CalculateDrawOrder(std::vector<GameObject *>& drawOrder)
 	}
 }
 
-void Game::CalculateCameraViewpoint()
+void Game::CalculateCameraViewpoint(Graphics *graphics)
 {
 	Vector4 xAxis(1.0f, 0.0f, 0.0f, 0.0f);
 	Vector4 yAxis(0.0f, 1.0f, 0.0f, 0.0f);
@@ -606,65 +300,49 @@ void Game::CalculateCameraViewpoint()
 	Vector3 cross = Vector3::Normalize(Vector3::Cross(cameraVector, lookAtVector));
 	float dot = MathUtils::ToDegrees(Vector3::Dot(lookAtVector, cameraVector));
 
-	glRotatef(cross.x * dot, 1.0f, 0.0f, 0.0f);
-	glRotatef(cross.y * dot, 0.0f, 1.0f, 0.0f);
-	glRotatef(cross.z * dot, 0.0f, 0.0f, 1.0f);
+	graphics->Rotate(cross.x * dot, 1.0f, 0.0f, 0.0f);
+	graphics->Rotate(cross.y * dot, 0.0f, 1.0f, 0.0f);
+	graphics->Rotate(cross.z * dot, 0.0f, 0.0f, 1.0f);
 
-	glTranslatef(-_camera->GetPosition().x, -_camera->GetPosition().y, -_camera->GetPosition().z);
+	graphics->Translate(-_camera->GetPosition().x, -_camera->GetPosition().y, -_camera->GetPosition().z);
 }
 
-void Game::DeployEnemy()
+void Game::OnPlayerMoved(const EventRange<PlayerMovedEvent> &)
 {
-	for (int i = 0; i < _numEnemies; i++)
-	{
-		if (_enemies[i].GetIsAlive() == false)
-		{
-			int posX = rand() % (int)(_gridWidth - 1);
-			int posY = rand() % (int)(_gridHeight - 1);
-			for (int x = 0; x < _numEnemies; x++)
-			{
-				if (_enemies[x].GetIsAlive() == true && _enemies[x].GetTransform().position.x == posX && _enemies[x].GetTransform().position.y == posY)
-				{
-					posX = rand() % (int)(_gridWidth - 1);
-					posY = rand() % (int)(_gridHeight - 1);
-					x = 0;
-				}
-				if (posX == 0 && posY == 0)
-				{
-					posX = rand() % (int)(_gridWidth - 1);
-					posY = rand() % (int)(_gridHeight - 1);
-					x = 0;
-				}
-			}
-			printf("Enemy deployed X: %d Y: %d\n", posX, posY);
-			_timeSinceLastEnemySpawn = 0;
-			_enemies[i].SetGridPos(Vector2(posX, posY));
-			_enemies[i].GetTransform() = _worldCubes[posX][posY].GetTransform();
-			_enemies[i].GetTransform().position.y += 1;
-			_enemies[i].SetIsAlive(true);
-			_timeSinceLastEnemyMoveMent = 0;
-			Mix_PlayChannel(-1, _enemySpawnSound, 0);
-			break;
-		}
-	}
+	AudioManager::GetInstance()->Play(_moveSound);
 }
 
-void Game::CheckPlayerEnemyCollisions()
+void Game::OnTilesVisited(const EventRange<TileVisitedEvent> &)
 {
-	for (int i = 0; i < _numEnemies; i++)
-	{
-		if (_enemies[i].GetIsAlive() == true)
-		{
-			if (_playerGridPos.x == _enemies[i].GetGridPos().x && _playerGridPos.y == _enemies[i].GetGridPos().y)
-			{
-				_playerLives -= 1;
-				_playerGridPos.x = 0;
-				_playerGridPos.y = 0;
-				_playerCube->GetTransform().position = Vector3(0, 1, 0);
-				Mix_PlayChannel(-1, _dieSound, 0);
-				break;
-			}
-		}
-	}
+	_isTitleDirty = true;
+	AudioManager::GetInstance()->Play(_visitedNewBlockSound);
+}
+
+void Game::OnPlayerDied(const EventRange<PlayerDiedEvent> &)
+{
+	_isTitleDirty = true;
+	AudioManager::GetInstance()->Play(_dieSound);
+}
+
+void Game::OnEnemiesSpawned(const EventRange<EnemySpawnedEvent> &)
+{
+	AudioManager::GetInstance()->Play(_enemySpawnSound);
+}
+
+void Game::OnEnemiesMoved(const EventRange<EnemiesMovedEvent> &)
+{
+	AudioManager::GetInstance()->Play(_enemyMovementSound);
+}
+
+void Game::OnLevelCleared(const EventRange<LevelClearedEvent> &)
+{
+	_isTitleDirty = true;
+	AudioManager::GetInstance()->Play(_clearLevelSound);
+}
+
+void Game::OnGameReset(const EventRange<GameResetEvent> &)
+{
+	_isTitleDirty = true;
+	AudioManager::GetInstance()->Play(_dieSound);
 }
 
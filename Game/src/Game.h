@@ -7,15 +7,16 @@
 #pragma once
 
 #include <GameEngine.h>
-#include <SDL_mixer.h>
+#include <InputActionMap.h>
+#include <AudioManager.h>
+#include "GameSimulation.h"
 
 //forward declarations
 union SDL_Event;
 class Graphics;
 class Camera;
 class Cube;
-class Enemy;
-struct Mix_Chunk;
+class WorldMesh;
 
 class Game : public GameEngine
 {
@@ -28,7 +29,41 @@ public:
 	*/
 	~Game();
 
+	/**
+	* \fn GameSimulation* Game::GetSimulation()
+	* \brief Gets the rules and state of the game being played, eg. to save or restore a snapshot of it
+	*/
+	GameSimulation* GetSimulation();
+
+	/**
+	* \fn void Game::SetStartingGridSize(int size)
+	* \brief A function that sets how many tiles a side the first level has, call before Initialize
+	* \param size tiles along each side, levels past 9 scroll with the player
+	*/
+	void SetStartingGridSize(int size);
+
+	/**
+	* \fn void Game::SetEnemyCapacity(int capacity)
+	* \brief A function that sets the most enemies alive at once, call before Initialize
+	*/
+	void SetEnemyCapacity(int capacity);
+
+	/**
+	* \fn void Game::SetActiveChunkRadius(int radius)
+	* \brief A function that sets how many chunks of tiles stay loaded around the player, call before Initialize
+	*/
+	void SetActiveChunkRadius(int radius);
+
 protected:
+	//actions the player can trigger, bound to keys in InitializeImpl
+	enum GameAction
+	{
+		ACTION_MOVE_UP,
+		ACTION_MOVE_DOWN,
+		ACTION_MOVE_LEFT,
+		ACTION_MOVE_RIGHT
+	};
+
 	/**
 	* \fn void Game::Game()
 	* \brief Default constructor for class Game
@@ -66,107 +101,61 @@ protected:
 	void CalculateDrawOrder(std::vector<GameObject *>& drawOrder);
 
 	/**
-	* \fn void Game::CalculateCameraViewpoint()
+	* \fn void Game::CalculateCameraViewpoint(Graphics *graphics)
 	* \brief A function that is used to calculate the game cameras viewpoint
+	* \param graphics The Graphics object the viewpoint is applied to.
 	*/
-	void CalculateCameraViewpoint();
-
-	/**
-	* \fn int Game::UpdateCubeVisitState()
-	* \brief A function that is used to check if cubes have been visited and notifies the game when all have been visited
-	* \return 1 if all cubes have been visited 0 if some still need to be visted
-	*/
-	int UpdateCubeVisitState();
-
-	/**
-	* \fn int Game::NextGameLevel(Graphics *graphics)
-	* \brief A function that is used to increment the games difficulty to the next level
-	* \param graphics The Graphics object used to draw the game.
-	*/
-	void NextGameLevel(Graphics *graphics);
+	void CalculateCameraViewpoint(Graphics *graphics);
 
 	/**
-	* \fn int Game::ResetGame(Graphics *graphics)
-	* \brief A function that is used to reset the game to its starting state
-	* \param graphics The Graphics object used to draw the game.
+	* \fn void Game::OnPlayerMoved(const EventRange<PlayerMovedEvent> &events)
+	* \brief The event handlers, each is called once per tick with every event of its type
+	* \param events the events published during the tick
 	*/
-	void ResetGame(Graphics *graphics);
+	void OnPlayerMoved(const EventRange<PlayerMovedEvent> &events);
+	void OnTilesVisited(const EventRange<TileVisitedEvent> &events);
+	void OnPlayerDied(const EventRange<PlayerDiedEvent> &events);
+	void OnEnemiesSpawned(const EventRange<EnemySpawnedEvent> &events);
+	void OnEnemiesMoved(const EventRange<EnemiesMovedEvent> &events);
+	void OnLevelCleared(const EventRange<LevelClearedEvent> &events);
+	void OnGameReset(const EventRange<GameResetEvent> &events);
 
-	/**
-	* \fn int Game::DeployEnemy()
-	* \brief A function that is called to deploy the first available enemy to the game world
-	*/
-	void DeployEnemy();
-
-	/**
-	* \fn int Game::CheckPlayerEnemyCollisions()
-	* \brief A function that is called to check if the player has collided with an enemy
-	*/
-	void CheckPlayerEnemyCollisions();
+	//the rules and state of the game, everything else here only shows it and feeds it input
+	GameSimulation _simulation;
 
 	//game camera
 	Camera *_camera;
 
-	//two dimensional array of ints used to track which cubes have been visited
-	int **_visitedCubes;
-
-	//game grid width
-	float _gridWidth;
-
-	//game grid height
-	float _gridHeight;
+	//key bindings of the player actions
+	InputActionMap _actions;
 
 	//cube representing the player
 	Cube *_playerCube;
 
-	//two dimensionl array of cubes
-	Cube **_worldCubes;
+	//merged mesh used to draw the world tiles
+	WorldMesh *_worldMesh;
 
 	//sound played when player moves
-	Mix_Chunk *_moveSound;
+	SoundId _moveSound;
 
 	//sound played when player loses a life
-	Mix_Chunk *_dieSound;
+	SoundId _dieSound;
 
 	//sound played when player clears a level
-	Mix_Chunk *_clearLevelSound;
+	SoundId _clearLevelSound;
 
 	//sound played when player clears a level
-	Mix_Chunk *_visitedNewBlockSound;
+	SoundId _visitedNewBlockSound;
 
 	//sound played when an enemy spawns
-	Mix_Chunk *_enemySpawnSound;
+	SoundId _enemySpawnSound;
 
 	//sound played when enemy moves
-	Mix_Chunk *_enemyMovementSound;
-
-	//player score
-	int _playerScore;
-
-	//player lives
-	int _playerLives;
-
-	//player game grid 2D position
-	Vector2 _playerGridPos;
+	SoundId _enemyMovementSound;
 
 	//string used for window title
 	char* _windowString;
 
-	//array of enemies
-	Enemy *_enemies;
-
-	//number of enemies in array
-	int _numEnemies;
-
-	//enemy deploy rate in number of seconds
-	float _enemyDeployRate;
-
-	//time in seconds since last enemy spawn
-	float _timeSinceLastEnemySpawn;
-
-	//time in seconds since last enemy movement
-	float _timeSinceLastEnemyMoveMent;
-
-	//interval in seconds that the enemies should move at
-	float _enemyMovementSpeed;
+	//set when the score, lives or fps changed since the window title was last written
+	bool _isTitleDirty;
 };
\ No newline at end of file
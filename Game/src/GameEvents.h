@@ -0,0 +1,47 @@
+/**
+* \class GameEvents.h
+* \brief The events a GameSimulation publishes on its EventBus, scoring, audio and the window title react to them
+*/
+#pragma once
+
+//the player stepped onto a tile
+struct PlayerMovedEvent
+{
+	int gridX, gridZ;
+};
+
+//the player stepped onto a tile nobody had visited yet
+struct TileVisitedEvent
+{
+	int gridX, gridZ;
+};
+
+//the player fell off the grid or was hit by an enemy, and lost a life
+struct PlayerDiedEvent
+{
+	int gridX, gridZ;
+};
+
+//an enemy appeared on a tile
+struct EnemySpawnedEvent
+{
+	int gridX, gridZ;
+};
+
+//enemies stepped down the staircase
+struct EnemiesMovedEvent
+{
+	int count;
+};
+
+//every tile was visited, the next level is a new grid of the given size
+struct LevelClearedEvent
+{
+	int gridRows, gridColumns;
+};
+
+//the player ran out of lives and the game started over
+struct GameResetEvent
+{
+	int gridRows, gridColumns;
+};
\ No newline at end of file
@@ -0,0 +1,473 @@
+#include "GameSimulation.h"
+#include <stdio.h>
+
+//chunks of tiles kept loaded around the player in every direction unless set otherwise. Enemies live in the same
+//area, which starts in the level's corner with the player: room for ((radius + 1) * 16)^2 enemies, 2,300 at 2
+static const int kDefaultActiveChunkRadius = 2;
+
+//at most this many enemies chase the player at once, a new enemy becomes one in kChaserOdds
+static const int kMaxChasers = 2;
+static const int kChaserOdds = 4;
+
+//however big the levels get, enemies deploy at most once a second and move at most every tenth of a second
+static const float kMinEnemyDeployRate = 1.0f;
+static const float kMinEnemyMovementSpeed = 0.1f;
+
+//the game's own values in a snapshot, written with a single copy ahead of the tiles, occupancy and enemies
+struct SnapshotState
+{
+	Sint32 gridRows, gridColumns;
+	Sint32 playerGridX, playerGridZ;
+	Sint32 activeChunkRow, activeChunkColumn;
+	Sint32 playerScore;
+	Sint32 playerLives;
+	float enemyDeployRate;
+	float enemyMovementSpeed;
+	float timeSinceLastEnemySpawn;
+};
+
+GameSimulation::GameSimulation() :
+_startingGridSize(4),
+_gridRows(0),
+_gridColumns(0),
+_activeChunkRow(-1),
+_activeChunkColumn(-1),
+_playerGridX(0),
+_playerGridZ(0),
+_playerScore(0),
+_playerLives(0),
+_numEnemies(10),
+_activeChunkRadius(kDefaultActiveChunkRadius),
+_enemyDeployRate(0),
+_timeSinceLastEnemySpawn(0),
+_enemyMovementSpeed(0)
+{
+	//channels are dispatched in the order they are created, TileVisitedEvent has to come before GameResetEvent so a
+	//reset wipes the score of its own tick. Creating them here also hands out the event type ids on the thread that
+	//builds the simulation, before it may run on another.
+	_events.Register<PlayerMovedEvent>();
+	_events.Register<TileVisitedEvent>();
+	_events.Register<PlayerDiedEvent>();
+	_events.Register<EnemySpawnedEvent>();
+	_events.Register<EnemiesMovedEvent>();
+	_events.Register<LevelClearedEvent>();
+	_events.Register<GameResetEvent>();
+
+	_events.Subscribe<TileVisitedEvent, GameSimulation, &GameSimulation::OnTilesVisited>(this);
+	_events.Subscribe<GameResetEvent, GameSimulation, &GameSimulation::OnGameReset>(this);
+}
+
+void GameSimulation::SetStartingGridSize(int size)
+{
+	_startingGridSize = (size > 1) ? size : 2;
+}
+
+void GameSimulation::SetEnemyCapacity(int capacity)
+{
+	_numEnemies = (capacity > 0) ? capacity : 1;
+}
+
+void GameSimulation::SetActiveChunkRadius(int radius)
+{
+	_activeChunkRadius = (radius > 0) ? radius : 1;
+}
+
+int GameSimulation::DeployEnemies(int count)
+{
+	int deployed = 0;
+	for (; deployed < count; deployed++)
+	{
+		if (DeployEnemy() == false)
+		{
+			break;
+		}
+	}
+
+	return deployed;
+}
+
+void GameSimulation::Initialize(Uint32 seed)
+{
+	_random.Seed(seed, RANDOM_STREAM_GAME);
+
+	_enemyDeployRate = 5;//deploy every 5 seconds
+
+	_enemyMovementSpeed = 1;//move down every second
+
+	//initialize array of enemies
+	_enemies.Initialize(_numEnemies);
+	_enemies.Seed(seed, RANDOM_STREAM_ENEMIES);
+
+	//set too zero since no enemies have spawned yet
+	_timeSinceLastEnemySpawn = 0;
+
+	//set player starting score and lives
+	_playerScore = 0;
+	_playerLives = 5;
+
+	//initial player game grid position
+	_playerGridX = 0;
+	_playerGridZ = 0;
+
+	//initialize world grid
+	_gridRows = _startingGridSize;
+	_gridColumns = _startingGridSize;
+
+	BuildLevel();
+
+	SaveSnapshot(_initialSnapshot);
+}
+
+void GameSimulation::Update(float dt, PlayerMove move)
+{
+	if (IsPlayerOnGrid())
+	{
+		MovePlayer(move);
+	}
+	else
+	{
+		KillPlayer();
+	}
+
+	//keep the world loaded around the player
+	FollowPlayer();
+
+	//deploy enemies
+	_timeSinceLastEnemySpawn += dt;
+	if (_timeSinceLastEnemySpawn > _enemyDeployRate)
+	{
+		DeployEnemy();
+	}
+
+	//chasers head for the player, the field is only rebuilt when the player is on another tile than last time
+	_pathfinder.UpdateFlowField(_chaseField, _playerGridX, _playerGridZ);
+
+	//move enemies, each on its own timer, the ones that fall off the grid die
+	EnemiesMovedEvent enemiesMoved = { _enemies.Update(dt, _enemyMovementSpeed, _occupancy, _chaseField) };
+	if (enemiesMoved.count > 0)
+	{
+		_events.Publish(enemiesMoved);
+	}
+
+	//check cubes if they are visited
+	int allVisted = UpdateCubeVisitState();
+	if (allVisted == 1)
+	{
+		NextGameLevel();
+		allVisted = 0;
+	}
+
+	//check for player collisions with enemies
+	CheckPlayerEnemyCollisions();
+
+	if (_playerLives < 0)
+	{
+		Reset();
+	}
+
+	//the simulation's own scoring runs first, then whoever else subscribed
+	_events.Dispatch();
+}
+
+void GameSimulation::Reset()
+{
+	//go back to the state right after Initialize, keeping the random numbers going so the new game plays out differently
+	Random random = _random;
+	RestoreSnapshot(_initialSnapshot);
+	_random = random;
+	_enemies.Seed(_random.Next(), RANDOM_STREAM_ENEMIES);
+
+	GameResetEvent reset = { _gridRows, _gridColumns };
+	_events.Publish(reset);
+}
+
+void GameSimulation::SaveSnapshot(Snapshot &snapshot)
+{
+	SnapshotState state;
+	state.gridRows = _gridRows;
+	state.gridColumns = _gridColumns;
+	state.playerGridX = _playerGridX;
+	state.playerGridZ = _playerGridZ;
+	state.activeChunkRow = _activeChunkRow;
+	state.activeChunkColumn = _activeChunkColumn;
+	state.playerScore = _playerScore;
+	state.playerLives = _playerLives;
+	state.enemyDeployRate = _enemyDeployRate;
+	state.enemyMovementSpeed = _enemyMovementSpeed;
+	state.timeSinceLastEnemySpawn = _timeSinceLastEnemySpawn;
+
+	snapshot.Clear();
+	snapshot.Write(state);
+	_random.Save(snapshot);
+	_tiles.Save(snapshot);
+	_occupancy.Save(snapshot);
+	_enemies.Save(snapshot);
+}
+
+bool GameSimulation::RestoreSnapshot(Snapshot &snapshot)
+{
+	SnapshotState state;
+	snapshot.BeginRead();
+	if ((snapshot.Read(state) && _random.Restore(snapshot) && _tiles.Restore(snapshot) && _occupancy.Restore(snapshot) && _enemies.Restore(snapshot)) == false)
+	{
+		printf("GameSimulation: snapshot is incomplete\n");
+		return false;
+	}
+
+	_gridRows = state.gridRows;
+	_gridColumns = state.gridColumns;
+	_playerGridX = state.playerGridX;
+	_playerGridZ = state.playerGridZ;
+	_activeChunkRow = state.activeChunkRow;
+	_activeChunkColumn = state.activeChunkColumn;
+	_playerScore = state.playerScore;
+	_playerLives = state.playerLives;
+	_enemyDeployRate = state.enemyDeployRate;
+	_enemyMovementSpeed = state.enemyMovementSpeed;
+	_timeSinceLastEnemySpawn = state.timeSinceLastEnemySpawn;
+
+	//only changed tiles are saved, the rest are generated again as the player gets near them
+	int firstRow, firstColumn, lastRow, lastColumn;
+	GetActiveArea(firstRow, firstColumn, lastRow, lastColumn);
+	_pathfinder.Resize(lastRow - firstRow, lastColumn - firstColumn, firstRow, firstColumn);
+	return true;
+}
+
+EventBus* GameSimulation::GetEventBus()
+{
+	return &_events;
+}
+
+ChunkedStateGrid* GameSimulation::GetTiles()
+{
+	return &_tiles;
+}
+
+EnemySwarm* GameSimulation::GetEnemies()
+{
+	return &_enemies;
+}
+
+int GameSimulation::GetGridRows() const
+{
+	return _gridRows;
+}
+
+int GameSimulation::GetGridColumns() const
+{
+	return _gridColumns;
+}
+
+int GameSimulation::GetPlayerGridX() const
+{
+	return _playerGridX;
+}
+
+int GameSimulation::GetPlayerGridZ() const
+{
+	return _playerGridZ;
+}
+
+bool GameSimulation::IsPlayerOnGrid() const
+{
+	return _playerGridX > -1 && _playerGridX < _gridRows && _playerGridZ > -1 && _playerGridZ < _gridColumns;
+}
+
+int GameSimulation::GetScore() const
+{
+	return _playerScore;
+}
+
+int GameSimulation::GetLives() const
+{
+	return _playerLives;
+}
+
+Vector3 GameSimulation::GetPlayerPosition() const
+{
+	return Vector3((float)_playerGridX, (float)(1 - (_playerGridX + _playerGridZ)), (float)_playerGridZ);
+}
+
+void GameSimulation::MovePlayer(PlayerMove move)
+{
+	switch (move)
+	{
+	case MOVE_UP:
+		_playerGridZ--;
+		break;
+	case MOVE_DOWN:
+		_playerGridZ++;
+		break;
+	case MOVE_RIGHT:
+		_playerGridX++;
+		break;
+	case MOVE_LEFT:
+		_playerGridX--;
+		break;
+	default:
+		return;
+	}
+
+	PlayerMovedEvent moved = { _playerGridX, _playerGridZ };
+	_events.Publish(moved);
+}
+
+int GameSimulation::UpdateCubeVisitState()
+{
+	if (IsPlayerOnGrid())
+	{
+		//if the cubes hasnt been visited already, the tile listeners are told about the change
+		if (_tiles.Set(_playerGridX, _playerGridZ, TILE_VISITED))
+		{
+			TileVisitedEvent visited = { _playerGridX, _playerGridZ };
+			_events.Publish(visited);
+		}
+	}
+
+	//the grid keeps count, no need to look at every tile
+	return (_tiles.GetCount(TILE_UNVISITED) == 0) ? 1 : 0;
+}
+
+void GameSimulation::NextGameLevel()
+{
+	//increment grid size, once it no longer fits on screen the enemies speed up too
+	_gridRows++;
+	_gridColumns++;
+	if (_gridRows > kFixedViewSize)
+	{
+		_enemyDeployRate -= 1;
+		if (_enemyDeployRate < kMinEnemyDeployRate)
+		{
+			_enemyDeployRate = kMinEnemyDeployRate;
+		}
+		_enemyMovementSpeed -= 0.1f;
+		if (_enemyMovementSpeed < kMinEnemyMovementSpeed)
+		{
+			_enemyMovementSpeed = kMinEnemyMovementSpeed;
+		}
+	}
+
+	//set player game pos to origin
+	_playerGridX = 0;
+	_playerGridZ = 0;
+
+	BuildLevel();
+
+	_playerLives++;
+
+	LevelClearedEvent cleared = { _gridRows, _gridColumns };
+	_events.Publish(cleared);
+}
+
+void GameSimulation::BuildLevel()
+{
+	//every tile starts out unvisited, chunks are loaded when the player gets near them and tile listeners follow
+	//the chunks that are loaded
+	_tiles.Resize(_gridRows, _gridColumns, TILE_UNVISITED);
+
+	//load the chunks around the player and place the enemy area there
+	_activeChunkRow = -1;
+	_activeChunkColumn = -1;
+	FollowPlayer();
+}
+
+void GameSimulation::FollowPlayer()
+{
+	//chunks generated since the last tick show up, the ones around the player are asked for
+	_tiles.Update();
+	_tiles.SetFocus(_playerGridX, _playerGridZ, _activeChunkRadius);
+
+	int playerRow = (_playerGridX < 0) ? 0 : (_playerGridX < _gridRows) ? _playerGridX : _gridRows - 1;
+	int playerColumn = (_playerGridZ < 0) ? 0 : (_playerGridZ < _gridColumns) ? _playerGridZ : _gridColumns - 1;
+
+	int chunkRow = playerRow / ChunkedStateGrid::kChunkSize;
+	int chunkColumn = playerColumn / ChunkedStateGrid::kChunkSize;
+	if (chunkRow == _activeChunkRow && chunkColumn == _activeChunkColumn)
+	{
+		return;
+	}
+
+	_activeChunkRow = chunkRow;
+	_activeChunkColumn = chunkColumn;
+
+	int firstRow, firstColumn, lastRow, lastColumn;
+	GetActiveArea(firstRow, firstColumn, lastRow, lastColumn);
+
+	//every tile can be walked on, so nothing is blocked for the pathfinder
+	_pathfinder.Resize(lastRow - firstRow, lastColumn - firstColumn, firstRow, firstColumn);
+
+	//enemies spawn away from the player's start and off the far edges, cells outside the area are ignored
+	_occupancy.Resize(lastRow - firstRow, lastColumn - firstColumn, _numEnemies, firstRow, firstColumn);
+	_occupancy.SetBlocked(0, 0, true);
+	for (int gridX = firstRow; gridX < lastRow; gridX++)
+	{
+		_occupancy.SetBlocked(gridX, _gridColumns - 1, true);
+	}
+	for (int gridZ = firstColumn; gridZ < lastColumn; gridZ++)
+	{
+		_occupancy.SetBlocked(_gridRows - 1, gridZ, true);
+	}
+
+	//enemies still alive carry over, unless the area moved away from under them
+	_enemies.Place(_occupancy);
+}
+
+void GameSimulation::GetActiveArea(int &firstRow, int &firstColumn, int &lastRow, int &lastColumn)
+{
+	//the same chunks that are loaded, clipped to the level
+	firstRow = (_activeChunkRow - _activeChunkRadius) * ChunkedStateGrid::kChunkSize;
+	firstColumn = (_activeChunkColumn - _activeChunkRadius) * ChunkedStateGrid::kChunkSize;
+	lastRow = (_activeChunkRow + _activeChunkRadius + 1) * ChunkedStateGrid::kChunkSize;
+	lastColumn = (_activeChunkColumn + _activeChunkRadius + 1) * ChunkedStateGrid::kChunkSize;
+	firstRow = (firstRow > 0) ? firstRow : 0;
+	firstColumn = (firstColumn > 0) ? firstColumn : 0;
+	lastRow = (lastRow < _gridRows) ? lastRow : _gridRows;
+	lastColumn = (lastColumn < _gridColumns) ? lastColumn : _gridColumns;
+}
+
+bool GameSimulation::DeployEnemy()
+{
+	//pick straight from the cells nobody is on, try again later if there are none or every enemy is out
+	if (_occupancy.GetFreeCellCount() == 0 || _enemies.GetAliveCount() == _enemies.GetCapacity())
+	{
+		return false;
+	}
+
+	int posX, posY;
+	_occupancy.GetFreeCell(_random.NextBelow(_occupancy.GetFreeCellCount()), posX, posY);
+	bool isChaser = (_random.NextBelow(kChaserOdds) == 0) && _enemies.GetChaserCount() < kMaxChasers;
+	_occupancy.Insert(_enemies.Spawn(posX, posY, _enemyMovementSpeed, isChaser), posX, posY);
+	_timeSinceLastEnemySpawn = 0;
+
+	EnemySpawnedEvent spawned = { posX, posY };
+	_events.Publish(spawned);
+	return true;
+}
+
+void GameSimulation::CheckPlayerEnemyCollisions()
+{
+	//only an enemy on the player's cell can hit it
+	if (_occupancy.IsOccupied(_playerGridX, _playerGridZ))
+	{
+		KillPlayer();
+	}
+}
+
+void GameSimulation::KillPlayer()
+{
+	PlayerDiedEvent died = { _playerGridX, _playerGridZ };
+	_events.Publish(died);
+	_playerLives -= 1;
+	_playerGridX = 0;
+	_playerGridZ = 0;
+}
+
+void GameSimulation::OnTilesVisited(const EventRange<TileVisitedEvent> &events)
+{
+	_playerScore += 5 * events.GetCount();
+}
+
+void GameSimulation::OnGameReset(const EventRange<GameResetEvent> &)
+{
+	_playerScore = 0;
+}
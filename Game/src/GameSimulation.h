@@ -0,0 +1,285 @@
+/**
+* \class GameSimulation.h
+* \brief A class that holds the rules and state of one game: tiles, player, enemies, score and difficulty. It has no
+* window, audio or input device and touches no singleton, so any number of them can run side by side, eg. headless
+* on worker threads. Game wraps one with the window, sounds and keyboard.
+*/
+#pragma once
+
+#include <ChunkedStateGrid.h>
+#include <EventBus.h>
+#include <GridOccupancy.h>
+#include <GridPathfinder.h>
+#include <MathUtils.h>
+#include <Random.h>
+#include <Snapshot.h>
+#include <SDL_stdinc.h>
+#include "EnemySwarm.h"
+#include "GameEvents.h"
+
+class GameSimulation
+{
+public:
+	//levels up to this size fit on screen, past it the camera scrolls and the enemies speed up as levels grow
+	static const int kFixedViewSize = 9;
+
+	//moves the player can make in a tick
+	enum PlayerMove
+	{
+		MOVE_NONE,
+		MOVE_UP,
+		MOVE_DOWN,
+		MOVE_LEFT,
+		MOVE_RIGHT
+	};
+
+	//random streams of the game seed, one per system that draws random numbers
+	enum RandomStream
+	{
+		RANDOM_STREAM_GAME,
+		RANDOM_STREAM_ENEMIES,
+		//first stream free for whoever drives the simulation, eg. a bot
+		RANDOM_STREAM_USER
+	};
+
+	//states of the world tiles
+	enum TileState
+	{
+		TILE_UNVISITED,
+		TILE_VISITED
+	};
+
+	/**
+	* \fn GameSimulation::GameSimulation()
+	* \brief Default constructor, creates the channels of every game event in the order they are dispatched
+	*/
+	GameSimulation();
+
+	/**
+	* \fn void GameSimulation::SetStartingGridSize(int size)
+	* \brief A function that sets how many tiles a side the first level has, call before Initialize
+	* \param size tiles along each side
+	*/
+	void SetStartingGridSize(int size);
+
+	/**
+	* \fn void GameSimulation::SetEnemyCapacity(int capacity)
+	* \brief A function that sets the most enemies alive at once, call before Initialize
+	* \param capacity the size of the swarm and of the occupancy grid's entity ids, 10 by default
+	*/
+	void SetEnemyCapacity(int capacity);
+
+	/**
+	* \fn void GameSimulation::SetActiveChunkRadius(int radius)
+	* \brief A function that sets how many chunks of tiles stay loaded around the player in every direction, call before
+	* Initialize. Enemies only live in that area, which starts in the level's corner with the player, so a big swarm
+	* needs a bigger radius, eg. 6 to deploy 10,000 enemies up front on a level of at least 102 tiles a side.
+	* \param radius chunks of 16 x 16 tiles on each side of the player's chunk, 2 by default
+	*/
+	void SetActiveChunkRadius(int radius);
+
+	/**
+	* \fn int GameSimulation::DeployEnemies(int count)
+	* \brief A function that deploys enemies straight away rather than on the spawn timer, eg. to fill the swarm for
+	* a stress test. Stops early when every enemy is out or the area around the player has no free tile left, see
+	* SetActiveChunkRadius.
+	* \param count how many enemies to deploy
+	* \return how many were deployed
+	*/
+	int DeployEnemies(int count);
+
+	/**
+	* \fn void GameSimulation::Initialize(Uint32 seed)
+	* \brief A function that starts a new game. Add tile listeners before calling it, the first chunks load here.
+	* \param seed every random number of the game comes from it, the same seed and moves play out the same
+	*/
+	void Initialize(Uint32 seed);
+
+	/**
+	* \fn void GameSimulation::Update(float dt, PlayerMove move)
+	* \brief A function that advances the game one tick and dispatches the tick's events
+	* \param dt The time in fractions of a second since the last tick.
+	* \param move what the player does this tick, ignored while the player is off the grid
+	*/
+	void Update(float dt, PlayerMove move);
+
+	/**
+	* \fn void GameSimulation::Reset()
+	* \brief A function that starts the game over, keeping the random numbers going so the new game plays out differently
+	*/
+	void Reset();
+
+	/**
+	* \fn void GameSimulation::SaveSnapshot(Snapshot &snapshot)
+	* \brief A function that writes the whole game state to a snapshot: grid size, tiles, player, enemies, timers and
+	* the random number state. Cheap enough to call every tick.
+	* \param snapshot the snapshot to write to, its previous contents are dropped
+	*/
+	void SaveSnapshot(Snapshot &snapshot);
+
+	/**
+	* \fn bool GameSimulation::RestoreSnapshot(Snapshot &snapshot)
+	* \brief A function that puts the game back in the state a snapshot was saved in, tile listeners hear about the
+	* chunks that changed
+	* \param snapshot the snapshot to read from
+	* \return false if the snapshot was incomplete, the game state is then unspecified
+	*/
+	bool RestoreSnapshot(Snapshot &snapshot);
+
+	/**
+	* \fn EventBus* GameSimulation::GetEventBus()
+	* \brief Gets the bus the game's events are published on, dispatched at the end of every Update
+	*/
+	EventBus* GetEventBus();
+
+	/**
+	* \fn ChunkedStateGrid* GameSimulation::GetTiles()
+	* \brief Gets the tiles, to add listeners to them. Only the simulation may change them.
+	*/
+	ChunkedStateGrid* GetTiles();
+
+	/**
+	* \fn EnemySwarm* GameSimulation::GetEnemies()
+	* \brief Gets the enemies, to draw them. Only the simulation may change them.
+	*/
+	EnemySwarm* GetEnemies();
+
+	int GetGridRows() const;
+	int GetGridColumns() const;
+	int GetPlayerGridX() const;
+	int GetPlayerGridZ() const;
+	bool IsPlayerOnGrid() const;
+	int GetScore() const;
+	int GetLives() const;
+
+	/**
+	* \fn Vector3 GameSimulation::GetPlayerPosition() const
+	* \brief Gets where the player is drawn, one above its tile on the staircase
+	*/
+	Vector3 GetPlayerPosition() const;
+
+protected:
+	/**
+	* \fn void GameSimulation::MovePlayer(PlayerMove move)
+	* \brief A function that steps the player one tile, possibly off the grid
+	* \param move the direction, MOVE_NONE does nothing
+	*/
+	void MovePlayer(PlayerMove move);
+
+	/**
+	* \fn int GameSimulation::UpdateCubeVisitState()
+	* \brief A function that is used to check if cubes have been visited and notifies the game when all have been visited
+	* \return 1 if all cubes have been visited 0 if some still need to be visted
+	*/
+	int UpdateCubeVisitState();
+
+	/**
+	* \fn void GameSimulation::NextGameLevel()
+	* \brief A function that is used to increment the games difficulty to the next level
+	*/
+	void NextGameLevel();
+
+	/**
+	* \fn void GameSimulation::BuildLevel()
+	* \brief A function that lays out the tiles and enemy area for the current grid size, reusing their memory
+	*/
+	void BuildLevel();
+
+	/**
+	* \fn void GameSimulation::FollowPlayer()
+	* \brief A function that loads the tiles around the player and moves the area enemies live in along when the player
+	* enters another chunk
+	*/
+	void FollowPlayer();
+
+	/**
+	* \fn void GameSimulation::GetActiveArea(int &firstRow, int &firstColumn, int &lastRow, int &lastColumn)
+	* \brief A function that gets the tiles enemies live in, the loaded chunks around the active chunk clipped to the level
+	* \param lastRow, lastColumn one past the last tile of the area
+	*/
+	void GetActiveArea(int &firstRow, int &firstColumn, int &lastRow, int &lastColumn);
+
+	/**
+	* \fn bool GameSimulation::DeployEnemy()
+	* \brief A function that is called to deploy the first available enemy to the game world
+	* \return false if every enemy is out or there is no free tile to put one on
+	*/
+	bool DeployEnemy();
+
+	/**
+	* \fn void GameSimulation::CheckPlayerEnemyCollisions()
+	* \brief A function that is called to check if the player has collided with an enemy
+	*/
+	void CheckPlayerEnemyCollisions();
+
+	/**
+	* \fn void GameSimulation::KillPlayer()
+	* \brief A function that takes a life and puts the player back on the first tile
+	*/
+	void KillPlayer();
+
+	/**
+	* \fn void GameSimulation::OnTilesVisited(const EventRange<TileVisitedEvent> &events)
+	* \brief The scoring handlers, subscribed ahead of everyone else so the score is up to date for other handlers
+	* \param events the events published during the tick
+	*/
+	void OnTilesVisited(const EventRange<TileVisitedEvent> &events);
+	void OnGameReset(const EventRange<GameResetEvent> &events);
+
+	//events of the tick, dispatched at the end of Update
+	EventBus _events;
+
+	//state of every tile, indexed by grid x then grid z, counts how many are left to visit.
+	//only the chunks around the player are in memory, so levels can be far bigger than the screen
+	ChunkedStateGrid _tiles;
+
+	//size of the first level
+	int _startingGridSize;
+
+	//size of the current level
+	int _gridRows, _gridColumns;
+
+	//chunk the player was in when the enemy area was last placed, -1 to place it again
+	int _activeChunkRow, _activeChunkColumn;
+
+	//player tile, may be one off the grid until the next tick notices the fall
+	int _playerGridX, _playerGridZ;
+
+	//player score
+	int _playerScore;
+
+	//player lives
+	int _playerLives;
+
+	//state of the game right after Initialize, Reset goes back to it
+	Snapshot _initialSnapshot;
+
+	//every enemy, alive or not
+	EnemySwarm _enemies;
+
+	//most enemies alive at once
+	int _numEnemies;
+
+	//chunks loaded around the player in every direction
+	int _activeChunkRadius;
+
+	//which cells the live enemies are on, by index into _enemies, and which cells are free to spawn on.
+	//covers the loaded chunks around the player, enemies that walk out of it are dropped
+	GridOccupancy _occupancy;
+
+	//paths over the same area as _occupancy, and the field every chaser follows toward the player
+	GridPathfinder _pathfinder;
+	FlowField _chaseField;
+
+	//enemy deploy rate in number of seconds
+	float _enemyDeployRate;
+
+	//time in seconds since last enemy spawn
+	float _timeSinceLastEnemySpawn;
+
+	//interval in seconds that the enemies should move at
+	float _enemyMovementSpeed;
+
+	//enemy spawns, the enemies draw from their own stream
+	Random _random;
+};
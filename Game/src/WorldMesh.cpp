@@ -0,0 +1,227 @@
+#include "WorldMesh.h"
+#include <Graphics.h>
+#include <ChunkedStateGrid.h>
+
+//meshes follow the chunks the tile states are loaded in
+static const int kChunkSize = ChunkedStateGrid::kChunkSize;
+
+//corner offsets of a unit cube, same order as the Cube vertices
+static const float kCorners[8][3] =
+{
+	{ -0.5f, 0.5f, 0.5f },
+	{ 0.5f, 0.5f, 0.5f },
+	{ -0.5f, -0.5f, 0.5f },
+	{ 0.5f, -0.5f, 0.5f },
+	{ -0.5f, 0.5f, -0.5f },
+	{ 0.5f, 0.5f, -0.5f },
+	{ -0.5f, -0.5f, -0.5f },
+	{ 0.5f, -0.5f, -0.5f }
+};
+
+struct Face
+{
+	//outward normal
+	int normal[3];
+
+	//the four corners used by the face
+	int corners[4];
+
+	//two triangles indexing into corners, same winding as Cube
+	int triangles[6];
+};
+
+static const Face kFaces[6] =
+{
+	// front
+	{ { 0, 0, 1 }, { 0, 1, 2, 3 }, { 0, 1, 2, 1, 3, 2 } },
+	// right
+	{ { 1, 0, 0 }, { 1, 5, 3, 7 }, { 0, 1, 2, 1, 3, 2 } },
+	// back
+	{ { 0, 0, -1 }, { 5, 4, 7, 6 }, { 0, 1, 2, 1, 3, 2 } },
+	// left
+	{ { -1, 0, 0 }, { 4, 0, 6, 2 }, { 0, 1, 2, 2, 1, 3 } },
+	// top
+	{ { 0, 1, 0 }, { 4, 5, 0, 1 }, { 0, 1, 2, 1, 3, 2 } },
+	// bottom
+	{ { 0, -1, 0 }, { 2, 3, 6, 7 }, { 0, 1, 2, 1, 3, 2 } }
+};
+
+WorldMesh::WorldMesh() :
+_tiles(nullptr),
+_towardViewer(Vector3::Zero())
+{
+}
+
+void WorldMesh::SetViewDirection(Vector3 towardViewer)
+{
+	_towardViewer = towardViewer;
+
+	for (auto itr = _chunks.begin(); itr != _chunks.end(); itr++)
+	{
+		itr->dirty = true;
+	}
+}
+
+void WorldMesh::SetTiles(const ChunkedStateGrid *tiles)
+{
+	_tiles = tiles;
+}
+
+void WorldMesh::SetStateColours(Uint8 state, const Vector4 colours[8])
+{
+	if (_stateColours.size() < (state + 1) * 8u)
+	{
+		_stateColours.resize((state + 1) * 8);
+	}
+
+	for (int corner = 0; corner < 8; corner++)
+	{
+		_stateColours[state * 8 + corner] = colours[corner];
+	}
+}
+
+void WorldMesh::OnTileChanged(const StateChange &change)
+{
+	int index = FindChunk(change.row / kChunkSize, change.column / kChunkSize);
+	if (index != -1)
+	{
+		_chunks[index].dirty = true;
+	}
+}
+
+void WorldMesh::OnChunkChanged(const ChunkChange &change)
+{
+	int index = FindChunk(change.chunkRow, change.chunkColumn);
+	if (change.isLoaded)
+	{
+		if (index == -1)
+		{
+			_chunks.push_back(Chunk());
+			if (_spareChunks.empty() == false)
+			{
+				_chunks.back().Swap(_spareChunks.back());
+				_spareChunks.pop_back();
+			}
+			index = (int)_chunks.size() - 1;
+		}
+
+		_chunks[index].chunkRow = change.chunkRow;
+		_chunks[index].chunkColumn = change.chunkColumn;
+		_chunks[index].dirty = true;
+	}
+	else if (index != -1)
+	{
+		_spareChunks.push_back(Chunk());
+		_spareChunks.back().Swap(_chunks[index]);
+		_chunks[index].Swap(_chunks.back());
+		_chunks.pop_back();
+	}
+}
+
+void WorldMesh::Draw(Graphics *graphics)
+{
+	for (auto itr = _chunks.begin(); itr != _chunks.end(); itr++)
+	{
+		Chunk &chunk = *itr;
+		if (chunk.dirty)
+		{
+			RebuildChunk(chunk);
+		}
+
+		if (chunk.indices.empty())
+		{
+			continue;
+		}
+
+		graphics->DrawTriangles(&chunk.positions[0], &chunk.colours[0], chunk.positions.size(),
+			&chunk.indices[0], chunk.indices.size());
+	}
+}
+
+void WorldMesh::RebuildChunk(Chunk &chunk)
+{
+	chunk.positions.clear();
+	chunk.colours.clear();
+	chunk.indices.clear();
+	chunk.dirty = false;
+
+	const Uint8 *states = (_tiles != nullptr) ? _tiles->GetChunkStates(chunk.chunkRow, chunk.chunkColumn) : nullptr;
+	if (states == nullptr || _stateColours.empty())
+	{
+		return;
+	}
+
+	int firstRow = chunk.chunkRow * kChunkSize;
+	int firstColumn = chunk.chunkColumn * kChunkSize;
+	int lastRow = (firstRow + kChunkSize < _tiles->GetRows()) ? firstRow + kChunkSize : _tiles->GetRows();
+	int lastColumn = (firstColumn + kChunkSize < _tiles->GetColumns()) ? firstColumn + kChunkSize : _tiles->GetColumns();
+
+	for (int gridX = firstRow; gridX < lastRow; gridX++)
+	{
+		for (int gridZ = firstColumn; gridZ < lastColumn; gridZ++)
+		{
+			//world coordinates, the grid is laid out as a staircase
+			int worldX = gridX;
+			int worldY = -(gridX + gridZ);
+			int worldZ = gridZ;
+
+			//tiles in a state without colours get the colours of the first state
+			unsigned int state = states[(gridX - firstRow) * kChunkSize + gridZ - firstColumn];
+			const Vector4 *tileColours = (state * 8 < _stateColours.size()) ? &_stateColours[state * 8] : &_stateColours[0];
+
+			for (int faceIndex = 0; faceIndex < 6; faceIndex++)
+			{
+				const Face &face = kFaces[faceIndex];
+
+				//a face pointing away from the orthographic camera can never be seen
+				float facing = face.normal[0] * _towardViewer.x + face.normal[1] * _towardViewer.y + face.normal[2] * _towardViewer.z;
+				if (facing < 0.0f)
+				{
+					continue;
+				}
+
+				//a face pressed against another tile can never be seen either
+				if (IsTileAt(worldX + face.normal[0], worldY + face.normal[1], worldZ + face.normal[2]))
+				{
+					continue;
+				}
+
+				unsigned int firstVertex = chunk.positions.size();
+				for (int i = 0; i < 4; i++)
+				{
+					const float *corner = kCorners[face.corners[i]];
+					chunk.positions.push_back(Vector3(worldX + corner[0], worldY + corner[1], worldZ + corner[2]));
+					chunk.colours.push_back(tileColours[face.corners[i]]);
+				}
+
+				for (int i = 0; i < 6; i++)
+				{
+					chunk.indices.push_back(firstVertex + face.triangles[i]);
+				}
+			}
+		}
+	}
+}
+
+int WorldMesh::FindChunk(int chunkRow, int chunkColumn)
+{
+	for (int i = 0; i < (int)_chunks.size(); i++)
+	{
+		if (_chunks[i].chunkRow == chunkRow && _chunks[i].chunkColumn == chunkColumn)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+bool WorldMesh::IsTileAt(int x, int y, int z)
+{
+	if (_tiles->Contains(x, z) == false)
+	{
+		return false;
+	}
+
+	return y == -(x + z);
+}
\ No newline at end of file
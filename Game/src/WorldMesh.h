@@ -0,0 +1,127 @@
+/**
+* \class WorldMesh.h
+* \brief A class that merges the tiles of the game world into one mesh per loaded chunk, coloured by tile state
+*/
+#pragma once
+
+#include <MathUtils.h>
+#include <SDL_stdinc.h>
+#include <utility>
+#include <vector>
+
+class Graphics;
+struct StateChange;
+struct ChunkChange;
+class ChunkedStateGrid;
+
+class WorldMesh
+{
+public:
+	/**
+	* \fn WorldMesh::WorldMesh()
+	* \brief Default Constructor
+	*/
+	WorldMesh();
+
+	/**
+	* \fn void WorldMesh::SetViewDirection(Vector3 towardViewer)
+	* \brief Sets the direction pointing from the world toward the (orthographic) camera, faces pointing away are not built
+	* \param towardViewer the direction toward the viewer, Vector3::Zero() keeps every face
+	*/
+	void SetViewDirection(Vector3 towardViewer);
+
+	/**
+	* \fn void WorldMesh::SetTiles(const ChunkedStateGrid *tiles)
+	* \brief A function that sets the grid the tiles are read from, the staircase is as big as the grid and only its
+	* loaded chunks get a mesh. The mesh has to be one of the grid's chunk listeners.
+	* \param tiles the state of every tile, it has to outlive the mesh
+	*/
+	void SetTiles(const ChunkedStateGrid *tiles);
+
+	/**
+	* \fn void WorldMesh::SetStateColours(Uint8 state, const Vector4 colours[8])
+	* \brief A function that sets the corner colours OnTileChanged gives a tile entering the given state
+	* \param state the tile state
+	* \param colours the eight corner colours, in Cube vertex order
+	*/
+	void SetStateColours(Uint8 state, const Vector4 colours[8]);
+
+	/**
+	* \fn void WorldMesh::OnTileChanged(const StateChange &change)
+	* \brief A ChunkedStateGrid listener that has the chunk holding the tile rebuilt with the colours of its new state
+	* \param change the tile that changed and its new state
+	*/
+	void OnTileChanged(const StateChange &change);
+
+	/**
+	* \fn void WorldMesh::OnChunkChanged(const ChunkChange &change)
+	* \brief A ChunkedStateGrid chunk listener that gives a loaded chunk a mesh and takes it away from an evicted one
+	* \param change the chunk that was loaded or evicted
+	*/
+	void OnChunkChanged(const ChunkChange &change);
+
+	/**
+	* \fn void WorldMesh::Draw(Graphics *graphics)
+	* \brief A function that rebuilds dirty chunks and draws every loaded chunk with a single call
+	* \param graphics The Graphics object used to draw the game.
+	*/
+	void Draw(Graphics *graphics);
+
+protected:
+	struct Chunk
+	{
+		int chunkRow, chunkColumn;
+		bool dirty;
+
+		std::vector<Vector3> positions;
+		std::vector<Vector4> colours;
+		std::vector<unsigned int> indices;
+
+		//swaps everything, buffers included, without copying them
+		void Swap(Chunk &other)
+		{
+			std::swap(chunkRow, other.chunkRow);
+			std::swap(chunkColumn, other.chunkColumn);
+			std::swap(dirty, other.dirty);
+			positions.swap(other.positions);
+			colours.swap(other.colours);
+			indices.swap(other.indices);
+		}
+	};
+
+	/**
+	* \fn void WorldMesh::RebuildChunk(Chunk &chunk)
+	* \brief A function that regenerates the visible faces of every tile in a chunk
+	* \param chunk the chunk to rebuild
+	*/
+	void RebuildChunk(Chunk &chunk);
+
+	/**
+	* \fn int WorldMesh::FindChunk(int chunkRow, int chunkColumn)
+	* \brief A function that finds the mesh of a loaded chunk
+	* \return the index into _chunks, -1 if the chunk has no mesh
+	*/
+	int FindChunk(int chunkRow, int chunkColumn);
+
+	/**
+	* \fn bool WorldMesh::IsTileAt(int x, int y, int z)
+	* \brief A function that checks whether a tile occupies the given world cell
+	* \return true if a tile is there, false if not
+	*/
+	bool IsTileAt(int x, int y, int z);
+
+	//where the tile states and the size of the staircase come from
+	const ChunkedStateGrid *_tiles;
+
+	//faces whose normal points away from this direction are culled
+	Vector3 _towardViewer;
+
+	//eight corner colours per tile state
+	std::vector<Vector4> _stateColours;
+
+	//one per loaded chunk, only the chunks around the player are loaded so there are never more than a few dozen
+	std::vector<Chunk> _chunks;
+
+	//meshes of evicted chunks, kept to reuse their buffers
+	std::vector<Chunk> _spareChunks;
+};
\ No newline at end of file
@@ -1,20 +1,80 @@
 #include <iostream>
+#include <string.h>
 #include "Game.h"
+#include <Metrics.h>
+#include <InputRecorder.h>
 
 using namespace std;
 
 int main(int argc, char** argv)
 {
   GameEngine *engine = GameEngine::CreateInstance();
-  engine->Initialize();
 
-  while(true)
+  // --metrics <file> writes per-frame render statistics for automated perf runs.
+  // --record <file> logs the seed and every input event, --replay <file> plays such a log back headless,
+  // --headless runs without a window, --level-size <tiles> starts on a square level that many tiles a side,
+  // --enemies <count> sets the most enemies alive at once, --active-radius <chunks> how many chunks of tiles stay
+  // loaded around the player, which bounds how many enemies fit.
+  CsvMetricsSink *metrics = nullptr;
+  InputRecorder *recorder = nullptr;
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "--metrics") == 0 && i + 1 < argc)
+    {
+      metrics = new CsvMetricsSink(argv[++i]);
+      engine->SetMetricsSink(metrics);
+    }
+    else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc && recorder == nullptr)
+    {
+      recorder = new InputRecorder();
+      recorder->StartRecording(argv[++i], engine->GetSeed());
+      engine->SetInputRecorder(recorder);
+    }
+    else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc && recorder == nullptr)
+    {
+      recorder = new InputRecorder();
+      if (recorder->StartReplay(argv[++i]) == false)
+      {
+        delete recorder;
+        return 1;
+      }
+      engine->SetInputRecorder(recorder);
+      engine->SetHeadless(true);
+    }
+    else if (strcmp(argv[i], "--headless") == 0)
+    {
+      engine->SetHeadless(true);
+    }
+    else if (strcmp(argv[i], "--level-size") == 0 && i + 1 < argc)
+    {
+      static_cast<Game *>(engine)->SetStartingGridSize(atoi(argv[++i]));
+    }
+    else if (strcmp(argv[i], "--enemies") == 0 && i + 1 < argc)
+    {
+      static_cast<Game *>(engine)->SetEnemyCapacity(atoi(argv[++i]));
+    }
+    else if (strcmp(argv[i], "--active-radius") == 0 && i + 1 < argc)
+    {
+      static_cast<Game *>(engine)->SetActiveChunkRadius(atoi(argv[++i]));
+    }
+  }
+
+  if (engine->Initialize() == false)
+  {
+    delete recorder;
+    delete metrics;
+    return 1;
+  }
+
+  while (engine->IsRunning())
   {
     engine->Update();
     engine->Draw();
   }
 
   engine->Shutdown();
+  delete recorder;
+  delete metrics;
 
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,323 @@
+/**
+ * AssetCooker
+ * Purpose: Converts the game's source assets into the runtime formats of CookedFormats.h and packs them into an
+ * archive the game mounts at startup.
+ *
+ * Usage, from the Game directory: AssetCooker [--rate <hz>] [--channels <count>] res res.pak
+ *   .wav files are decoded and resampled to the mixer's output format and stored under their own path.
+ *   .obj files are flattened into vertex and index arrays and stored under the same path ending in .mesh.
+ *   Anything else is stored as-is, LZ4 compressed when that pays off.
+ */
+
+#include <CookedFormats.h>
+#include <PackedArchive.h>
+#include <SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <dirent.h>
+#endif
+
+// The format Game opens the mixer with (MIX_DEFAULT_FREQUENCY, AUDIO_U8, stereo). Sounds cooked for another
+// format still play, but are converted at load time.
+static const int kDefaultFrequency = 22050;
+static const Uint16 kDefaultFormat = AUDIO_U8;
+static const int kDefaultChannels = 2;
+
+static std::vector<std::string> ListFiles(const std::string &directory)
+{
+  std::vector<std::string> names;
+
+#ifdef _WIN32
+  WIN32_FIND_DATAA found;
+  HANDLE search = FindFirstFileA((directory + "/*").c_str(), &found);
+  if (search != INVALID_HANDLE_VALUE)
+  {
+    do
+    {
+      if ((found.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+      {
+        names.push_back(found.cFileName);
+      }
+    } while (FindNextFileA(search, &found));
+    FindClose(search);
+  }
+#else
+  DIR *search = opendir(directory.c_str());
+  if (search != nullptr)
+  {
+    for (dirent *found = readdir(search); found != nullptr; found = readdir(search))
+    {
+      if (found->d_type == DT_REG)
+      {
+        names.push_back(found->d_name);
+      }
+    }
+    closedir(search);
+  }
+#endif
+
+  return names;
+}
+
+static bool EndsWith(const std::string &text, const char *suffix)
+{
+  size_t length = strlen(suffix);
+  return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+}
+
+static bool ReadFile(const std::string &path, std::vector<Uint8> &contents)
+{
+  FILE *file = fopen(path.c_str(), "rb");
+  if (file == nullptr)
+  {
+    return false;
+  }
+
+  fseek(file, 0, SEEK_END);
+  contents.resize(ftell(file));
+  fseek(file, 0, SEEK_SET);
+  bool isRead = contents.empty() || fread(&contents[0], 1, contents.size(), file) == contents.size();
+  fclose(file);
+  return isRead;
+}
+
+template <typename T>
+static void Append(std::vector<Uint8> &output, const T *values, size_t count)
+{
+  const Uint8 *bytes = (const Uint8 *)values;
+  output.insert(output.end(), bytes, bytes + count * sizeof(T));
+}
+
+// Decodes a WAV and converts it to the mixer format, the same conversion Mix_LoadWAV does at runtime.
+static bool CookSound(const std::string &path, int frequency, Uint16 format, int channels, std::vector<Uint8> &output)
+{
+  SDL_AudioSpec spec;
+  Uint8 *samples;
+  Uint32 sampleBytes;
+  if (SDL_LoadWAV(path.c_str(), &spec, &samples, &sampleBytes) == nullptr)
+  {
+    printf("AssetCooker: %s: %s\n", path.c_str(), SDL_GetError());
+    return false;
+  }
+
+  SDL_AudioCVT converter;
+  if (SDL_BuildAudioCVT(&converter, spec.format, spec.channels, spec.freq, format, (Uint8)channels, frequency) < 0)
+  {
+    printf("AssetCooker: %s: %s\n", path.c_str(), SDL_GetError());
+    SDL_FreeWAV(samples);
+    return false;
+  }
+
+  std::vector<Uint8> pcm(sampleBytes * converter.len_mult);
+  if (pcm.empty() == false)
+  {
+    memcpy(&pcm[0], samples, sampleBytes);
+  }
+  SDL_FreeWAV(samples);
+
+  converter.buf = pcm.empty() ? nullptr : &pcm[0];
+  converter.len = (int)sampleBytes;
+  if (converter.needed && pcm.empty() == false)
+  {
+    SDL_ConvertAudio(&converter);
+    pcm.resize(converter.len_cvt);
+  }
+  else
+  {
+    pcm.resize(sampleBytes);
+  }
+
+  CookedSoundHeader header;
+  header.magic = kCookedSoundMagic;
+  header.frequency = (Uint32)frequency;
+  header.format = format;
+  header.channels = (Uint8)channels;
+  header.reserved = 0;
+  header.byteCount = (Uint32)pcm.size();
+
+  Append(output, &header, 1);
+  Append(output, pcm.empty() ? nullptr : &pcm[0], pcm.size());
+  return true;
+}
+
+// Flattens an OBJ into position, colour and index arrays. Vertex colours use the common "v x y z r g b"
+// extension; polygons are triangulated as fans. Texture coordinates and normals are ignored.
+static bool CookMesh(const std::string &path, std::vector<Uint8> &output)
+{
+  FILE *file = fopen(path.c_str(), "r");
+  if (file == nullptr)
+  {
+    printf("AssetCooker: could not open %s\n", path.c_str());
+    return false;
+  }
+
+  std::vector<float> positions;
+  std::vector<float> colours;
+  std::vector<Uint32> indices;
+  bool isValid = true;
+
+  char line[512];
+  for (int lineNumber = 1; fgets(line, sizeof(line), file) != nullptr && isValid; lineNumber++)
+  {
+    if (line[0] == 'v' && line[1] == ' ')
+    {
+      float x, y, z, r = 1.0f, g = 1.0f, b = 1.0f;
+      int count = sscanf(line + 2, "%f %f %f %f %f %f", &x, &y, &z, &r, &g, &b);
+      if (count != 3 && count != 6)
+      {
+        printf("AssetCooker: %s:%d: expected a position and an optional colour\n", path.c_str(), lineNumber);
+        isValid = false;
+        break;
+      }
+
+      float position[3] = { x, y, z };
+      float colour[4] = { r, g, b, 1.0f };
+      positions.insert(positions.end(), position, position + 3);
+      colours.insert(colours.end(), colour, colour + 4);
+    }
+    else if (line[0] == 'f' && line[1] == ' ')
+    {
+      std::vector<Uint32> polygon;
+      for (char *token = strtok(line + 2, " \t\r\n"); token != nullptr; token = strtok(nullptr, " \t\r\n"))
+      {
+        // "v", "v/vt", "v//vn" and "v/vt/vn" all start with the 1-based position index.
+        long index = strtol(token, nullptr, 10);
+        if (index < 1 || (size_t)index > positions.size() / 3)
+        {
+          printf("AssetCooker: %s:%d: face refers to a missing vertex\n", path.c_str(), lineNumber);
+          isValid = false;
+          break;
+        }
+        polygon.push_back((Uint32)(index - 1));
+      }
+
+      for (size_t i = 2; i < polygon.size() && isValid; i++)
+      {
+        indices.push_back(polygon[0]);
+        indices.push_back(polygon[i - 1]);
+        indices.push_back(polygon[i]);
+      }
+    }
+  }
+  fclose(file);
+
+  if (isValid == false || indices.empty())
+  {
+    printf("AssetCooker: %s has no usable triangles\n", path.c_str());
+    return false;
+  }
+
+  CookedMeshHeader header;
+  header.magic = kCookedMeshMagic;
+  header.vertexCount = (Uint32)(positions.size() / 3);
+  header.indexCount = (Uint32)indices.size();
+  header.reserved = 0;
+
+  Append(output, &header, 1);
+  Append(output, &positions[0], positions.size());
+  Append(output, &colours[0], colours.size());
+  Append(output, &indices[0], indices.size());
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  int frequency = kDefaultFrequency;
+  int channels = kDefaultChannels;
+  std::vector<const char *> paths;
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc)
+    {
+      frequency = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "--channels") == 0 && i + 1 < argc)
+    {
+      channels = atoi(argv[++i]);
+    }
+    else
+    {
+      paths.push_back(argv[i]);
+    }
+  }
+
+  if (paths.size() != 2 || frequency <= 0 || channels <= 0)
+  {
+    printf("usage: AssetCooker [--rate <hz>] [--channels <count>] <asset directory> <archive>\n");
+    return 1;
+  }
+
+  // Assets are looked up by the path the game would load them from, so the directory is also the path prefix.
+  std::string directory = paths[0];
+  while (directory.size() > 1 && (directory[directory.size() - 1] == '/' || directory[directory.size() - 1] == '\\'))
+  {
+    directory.erase(directory.size() - 1);
+  }
+
+  std::vector<std::string> names = ListFiles(directory);
+  if (names.empty())
+  {
+    printf("AssetCooker: no assets found in %s\n", directory.c_str());
+    return 1;
+  }
+
+  PackedArchiveWriter writer;
+  int failures = 0;
+  for (auto itr = names.begin(); itr != names.end(); itr++)
+  {
+    std::string source = directory + "/" + *itr;
+    std::vector<Uint8> cooked;
+
+    if (EndsWith(*itr, ".wav"))
+    {
+      if (CookSound(source, frequency, kDefaultFormat, channels, cooked))
+      {
+        // PCM barely compresses, and stored sounds play straight from the mapping.
+        writer.Add(source.c_str(), &cooked[0], cooked.size(), false);
+        printf("%s: sound, %u bytes\n", source.c_str(), (unsigned int)cooked.size());
+      }
+      else
+      {
+        failures++;
+      }
+    }
+    else if (EndsWith(*itr, ".obj"))
+    {
+      std::string target = source.substr(0, source.size() - 4) + ".mesh";
+      if (CookMesh(source, cooked))
+      {
+        writer.Add(target.c_str(), &cooked[0], cooked.size(), false);
+        printf("%s: mesh, %u bytes\n", target.c_str(), (unsigned int)cooked.size());
+      }
+      else
+      {
+        failures++;
+      }
+    }
+    else if (ReadFile(source, cooked))
+    {
+      writer.Add(source.c_str(), cooked.empty() ? nullptr : &cooked[0], cooked.size(), true);
+      printf("%s: %u bytes\n", source.c_str(), (unsigned int)cooked.size());
+    }
+    else
+    {
+      printf("AssetCooker: could not read %s\n", source.c_str());
+      failures++;
+    }
+  }
+
+  if (failures > 0 || writer.Write(paths[1]) == false)
+  {
+    printf("AssetCooker: %s was not written\n", paths[1]);
+    return 1;
+  }
+
+  return 0;
+}
\ No newline at end of file
@@ -0,0 +1,310 @@
+/**
+ * ChunkGridCheck
+ * Purpose: Checks ChunkedStateGrid's bookkeeping, the running counts and which chunks were counted, through
+ * generation, eviction, snapshots and chunks still generating. Every check runs once generating on the calling
+ * thread and once on a thread pool.
+ *
+ * Usage: ChunkGridCheck
+ *   Prints every check that failed and exits with 1 if any did, 0 otherwise.
+ */
+
+#include <ChunkedStateGrid.h>
+#include <Random.h>
+#include <Snapshot.h>
+#include <ThreadPool.h>
+#include <stdio.h>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+static const Uint8 kDefaultState = 0;
+static const Uint8 kChangedState = 3;
+
+static int failures = 0;
+
+static void Check(bool passed, const char *what, ThreadPool *threadPool)
+{
+  if (passed == false)
+  {
+    printf("ChunkGridCheck: %s (%s) failed\n", what, threadPool != nullptr ? "thread pool" : "calling thread");
+    failures++;
+  }
+}
+
+// Alternates whole chunks between states 1 and 2, so every chunk moves cells out of the default state.
+static Uint8 GetGeneratedState(int row, int column)
+{
+  return ((row / ChunkedStateGrid::kChunkSize + column / ChunkedStateGrid::kChunkSize) % 2) ? 1 : 2;
+}
+
+static void GenerateCheckerboard(int firstRow, int firstColumn, int rows, int columns, Uint8 *states)
+{
+  Uint8 state = GetGeneratedState(firstRow, firstColumn);
+  for (int row = 0; row < rows; row++)
+  {
+    for (int column = 0; column < columns; column++)
+    {
+      states[row * ChunkedStateGrid::kChunkSize + column] = state;
+    }
+  }
+}
+
+// Mirrors the chunk listener calls, a chunk is never loaded twice or evicted without being loaded.
+class ChunkTracker
+{
+public:
+  ChunkTracker() : _isConsistent(true) { }
+
+  void OnChunkChanged(const ChunkChange &change)
+  {
+    std::pair<int, int> chunk(change.chunkRow, change.chunkColumn);
+    if (change.isLoaded)
+    {
+      // A loaded chunk can be told about again when a snapshot replaces its contents.
+      _loaded.insert(chunk);
+    }
+    else if (_loaded.erase(chunk) == 0)
+    {
+      _isConsistent = false;
+    }
+  }
+
+  bool Matches(const ChunkedStateGrid &grid) const
+  {
+    return _isConsistent && (int)_loaded.size() == grid.GetLoadedChunkCount();
+  }
+
+private:
+  std::set<std::pair<int, int> > _loaded;
+  bool _isConsistent;
+};
+
+static void FinishPending(ChunkedStateGrid &grid)
+{
+  while (grid.GetPendingChunkCount() > 0)
+  {
+    grid.Update();
+    std::this_thread::yield();
+  }
+}
+
+static bool CountsAddUp(const ChunkedStateGrid &grid)
+{
+  int total = 0;
+  for (int state = 0; state < ChunkedStateGrid::kMaxStates; state++)
+  {
+    total += grid.GetCount((Uint8)state);
+  }
+  return total == grid.GetRows() * grid.GetColumns();
+}
+
+// Only meaningful while every chunk is loaded.
+static bool CountsMatchCells(const ChunkedStateGrid &grid)
+{
+  int counts[ChunkedStateGrid::kMaxStates] = { 0 };
+  for (int row = 0; row < grid.GetRows(); row++)
+  {
+    for (int column = 0; column < grid.GetColumns(); column++)
+    {
+      Uint8 state = grid.Get(row, column);
+      if (state == ChunkedStateGrid::kNotLoaded)
+      {
+        return false;
+      }
+      counts[state]++;
+    }
+  }
+
+  for (int state = 0; state < ChunkedStateGrid::kMaxStates; state++)
+  {
+    if (counts[state] != grid.GetCount((Uint8)state))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+static std::vector<Uint8> CopyCells(const ChunkedStateGrid &grid)
+{
+  std::vector<Uint8> cells;
+  for (int row = 0; row < grid.GetRows(); row++)
+  {
+    for (int column = 0; column < grid.GetColumns(); column++)
+    {
+      cells.push_back(grid.Get(row, column));
+    }
+  }
+  return cells;
+}
+
+static void SetRandomCells(ChunkedStateGrid &grid, Random &random, int count)
+{
+  for (int i = 0; i < count; i++)
+  {
+    grid.Set(random.NextBelow(grid.GetRows()), random.NextBelow(grid.GetColumns()), (Uint8)random.NextBelow(4));
+  }
+}
+
+// A grid too big to load, walked across and back.
+static void CheckStreaming(ThreadPool *threadPool)
+{
+  ChunkedStateGrid grid;
+  ChunkTracker tracker;
+  grid.AddChunkListener<ChunkTracker, &ChunkTracker::OnChunkChanged>(&tracker);
+  grid.SetGenerator(GenerateCheckerboard, threadPool);
+  grid.Resize(1000, 700, kDefaultState);
+  Check(grid.GetCount(kDefaultState) == 700000, "a new grid counts every cell in the default state", threadPool);
+
+  grid.SetFocus(0, 0, 2);
+  Check(grid.Get(0, 0) != ChunkedStateGrid::kNotLoaded, "the chunk under the focus is loaded straight away", threadPool);
+  FinishPending(grid);
+  Check(grid.GetLoadedChunkCount() == 9, "a corner focus loads 3 x 3 chunks", threadPool);
+  Check(tracker.Matches(grid), "chunk listeners see every load", threadPool);
+
+  Check(grid.Set(5, 5, kChangedState), "a loaded cell can be changed", threadPool);
+  Check(grid.Set(5, 5, kChangedState) == false, "setting the same state changes nothing", threadPool);
+  Check(grid.GetCount(kChangedState) == 1, "a change is counted", threadPool);
+
+  Snapshot snapshot;
+  grid.Save(snapshot);
+
+  for (int row = 0; row < 1000; row += 7)
+  {
+    grid.SetFocus(row, row / 2, 2);
+    grid.Update();
+    Check(grid.Get(row, row / 2) != ChunkedStateGrid::kNotLoaded, "the focus chunk is loaded while walking", threadPool);
+    grid.Set(row, row / 2, kChangedState);
+  }
+  FinishPending(grid);
+  Check(grid.GetLoadedChunkCount() <= 7 * 7, "chunks out of range are evicted", threadPool);
+  Check(tracker.Matches(grid), "chunk listeners see every eviction", threadPool);
+  Check(CountsAddUp(grid), "the counts add up to the grid after walking", threadPool);
+
+  grid.SetFocus(5, 5, 2);
+  Check(grid.Get(5, 5) == kChangedState, "an evicted chunk keeps its changes", threadPool);
+
+  snapshot.BeginRead();
+  Check(grid.Restore(snapshot), "the snapshot restores", threadPool);
+  Check(grid.GetCount(kChangedState) == 1, "restoring brings the counts back", threadPool);
+  Check(CountsAddUp(grid), "the counts add up to the grid after restoring", threadPool);
+  grid.SetFocus(5, 5, 2);
+  FinishPending(grid);
+  Check(grid.Get(5, 5) == kChangedState, "a change from before the snapshot survives restoring", threadPool);
+  Check(grid.Get(7, 3) == GetGeneratedState(7, 3), "a chunk from before the snapshot is generated again", threadPool);
+  Check(tracker.Matches(grid), "chunk listeners follow a restore", threadPool);
+
+  grid.SetFocus(994, 497, 2);
+  FinishPending(grid);
+  Check(grid.Get(994, 497) == GetGeneratedState(994, 497), "a change made after the snapshot is gone", threadPool);
+}
+
+// A grid small enough to load whole, so the counts can be checked against every cell.
+static void CheckExactCounts(ThreadPool *threadPool)
+{
+  ChunkedStateGrid grid;
+  ChunkTracker tracker;
+  grid.AddChunkListener<ChunkTracker, &ChunkTracker::OnChunkChanged>(&tracker);
+  grid.SetGenerator(GenerateCheckerboard, threadPool);
+
+  // Ragged on both edges, so the partial chunks are counted too.
+  grid.Resize(60, 45, kDefaultState);
+  grid.SetFocus(30, 20, 4);
+  FinishPending(grid);
+  Check(grid.GetLoadedChunkCount() == 4 * 3, "a wide focus loads the whole grid", threadPool);
+  Check(CountsMatchCells(grid), "counts match the cells once everything was generated", threadPool);
+
+  Random random(1234);
+  SetRandomCells(grid, random, 500);
+  Check(CountsMatchCells(grid), "counts match the cells after changes", threadPool);
+
+  Snapshot snapshot;
+  grid.Save(snapshot);
+  std::vector<Uint8> savedCells = CopyCells(grid);
+
+  // Change more, then evict half the grid with the changes and some never changed.
+  SetRandomCells(grid, random, 500);
+  grid.SetFocus(0, 0, 0);
+  Check(grid.GetLoadedChunkCount() < 4 * 3, "moving the focus to a corner evicts the far chunks", threadPool);
+  Check(CountsAddUp(grid), "the counts add up to the grid with chunks evicted", threadPool);
+
+  snapshot.BeginRead();
+  Check(grid.Restore(snapshot), "the snapshot restores", threadPool);
+  grid.SetFocus(30, 20, 4);
+  FinishPending(grid);
+  Check(CopyCells(grid) == savedCells, "restoring brings every cell back", threadPool);
+  Check(CountsMatchCells(grid), "counts match the cells after restoring", threadPool);
+  Check(tracker.Matches(grid), "chunk listeners follow evictions and restores", threadPool);
+
+  // A snapshot of a grid that was only partly generated, restored once everything was.
+  grid.Resize(60, 45, kDefaultState);
+  grid.SetFocus(0, 0, 0);
+  FinishPending(grid);
+  grid.Set(1, 1, kChangedState);
+  snapshot.Clear();
+  grid.Save(snapshot);
+  grid.SetFocus(30, 20, 4);
+  FinishPending(grid);
+  snapshot.BeginRead();
+  Check(grid.Restore(snapshot), "a partly generated snapshot restores", threadPool);
+  grid.SetFocus(30, 20, 4);
+  FinishPending(grid);
+  Check(grid.Get(1, 1) == kChangedState, "the change in the partly generated snapshot survives", threadPool);
+  Check(CountsMatchCells(grid), "counts match the cells after restoring a partly generated snapshot", threadPool);
+}
+
+// Snapshots restored while the chunks they changed are still generating.
+static void CheckRestoreWhilePending(ThreadPool *threadPool)
+{
+  ChunkedStateGrid grid;
+  grid.SetGenerator(GenerateCheckerboard, threadPool);
+  grid.Resize(60, 45, kDefaultState);
+  grid.SetFocus(30, 20, 4);
+  FinishPending(grid);
+  grid.Set(1, 1, kChangedState);
+  grid.Set(20, 20, kChangedState);
+
+  Snapshot snapshot;
+  grid.Save(snapshot);
+  std::vector<Uint8> savedCells = CopyCells(grid);
+
+  // Start over, so the changed chunks are generated again from scratch and are left pending.
+  grid.Resize(60, 45, kDefaultState);
+  grid.SetFocus(40, 40, 4);
+
+  snapshot.BeginRead();
+  Check(grid.Restore(snapshot), "a snapshot restores while chunks generate", threadPool);
+
+  // The chunk under the focus is waited for, the rest arrive through Update.
+  grid.SetFocus(1, 1, 4);
+  Check(grid.Get(1, 1) == kChangedState, "a pending focus chunk takes its saved changes", threadPool);
+  FinishPending(grid);
+  Check(grid.Get(20, 20) == kChangedState, "a pending chunk takes its saved changes", threadPool);
+  Check(CopyCells(grid) == savedCells, "restoring over pending chunks brings every cell back", threadPool);
+  Check(CountsMatchCells(grid), "counts match the cells after restoring over pending chunks", threadPool);
+}
+
+static void CheckAll(ThreadPool *threadPool)
+{
+  CheckStreaming(threadPool);
+  CheckExactCounts(threadPool);
+  CheckRestoreWhilePending(threadPool);
+}
+
+int main()
+{
+  CheckAll(nullptr);
+
+  ThreadPool threadPool;
+  CheckAll(&threadPool);
+
+  if (failures > 0)
+  {
+    printf("ChunkGridCheck: %d checks failed\n", failures);
+    return 1;
+  }
+
+  printf("ChunkGridCheck: every check passed\n");
+  return 0;
+}
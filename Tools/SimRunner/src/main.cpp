@@ -0,0 +1,259 @@
+/**
+ * SimRunner
+ * Purpose: Plays many games at once without a window, audio or input devices, for balancing and to gather data for
+ * bots. Every instance is a GameSimulation with a simple bot at the keys, and instances are spread over the thread
+ * pool's workers. At the end the runner reports how fast the games ticked and how they went.
+ *
+ * Usage: SimRunner [--instances <count>] [--ticks <count>] [--threads <count>] [--level-size <tiles>] [--enemies <count>]
+ *                  [--active-radius <chunks>] [--seed <seed>]
+ *   Every instance runs the given number of 60 Hz ticks, as fast as the CPU allows. Instance i is seeded with
+ *   seed + i, so a run with the same arguments plays out the same. --enemies makes room for that many enemies and
+ *   deploys them all up front, as many as fit around the player, to stress the swarm. --active-radius sets how many
+ *   chunks stay loaded around the player, eg. --level-size 120 --enemies 10000 --active-radius 6 fills a 10,000 swarm.
+ */
+
+#include <GameSimulation.h>
+#include <Random.h>
+#include <ThreadPool.h>
+#include <SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <future>
+#include <vector>
+
+static const float kTickTime = 1.0f / 60.0f;
+
+// The bot presses a key every this many ticks, a quick human pace.
+static const int kTicksPerMove = 6;
+
+static const GameSimulation::PlayerMove kMoves[4] =
+{
+  GameSimulation::MOVE_UP, GameSimulation::MOVE_DOWN, GameSimulation::MOVE_LEFT, GameSimulation::MOVE_RIGHT
+};
+
+// Grid steps of kMoves, as (x, z).
+static const int kMoveSteps[4][2] = { { 0, -1 }, { 0, 1 }, { -1, 0 }, { 1, 0 } };
+
+// One game, the bot playing it and what happened in it. Built on the main thread, then run by one worker.
+class Instance
+{
+public:
+  Instance() :
+  _ticks(0),
+  _levelsCleared(0),
+  _deaths(0),
+  _gameOvers(0),
+  _bestScore(0),
+  _enemiesDeployed(0)
+  {
+  }
+
+  void Initialize(Uint32 seed, int levelSize, int enemyCount, int activeRadius)
+  {
+    // The bot draws from its own stream of the game seed, so it doesn't change what the game rolls.
+    _botRandom.Seed(seed, GameSimulation::RANDOM_STREAM_USER);
+
+    EventBus *events = _simulation.GetEventBus();
+    events->Subscribe<PlayerDiedEvent, Instance, &Instance::OnPlayerDied>(this);
+    events->Subscribe<LevelClearedEvent, Instance, &Instance::OnLevelCleared>(this);
+    events->Subscribe<GameResetEvent, Instance, &Instance::OnGameReset>(this);
+
+    _simulation.SetStartingGridSize(levelSize);
+    if (activeRadius > 0)
+    {
+      _simulation.SetActiveChunkRadius(activeRadius);
+    }
+    if (enemyCount > 0)
+    {
+      _simulation.SetEnemyCapacity(enemyCount);
+    }
+    _simulation.Initialize(seed);
+    _enemiesDeployed = _simulation.DeployEnemies(enemyCount);
+  }
+
+  void Run(int ticks)
+  {
+    for (int tick = 0; tick < ticks; tick++)
+    {
+      GameSimulation::PlayerMove move = (tick % kTicksPerMove == 0) ? ChooseMove() : GameSimulation::MOVE_NONE;
+      _simulation.Update(kTickTime, move);
+      UpdateBestScore();
+    }
+    _ticks += ticks;
+  }
+
+  int GetTicks() const { return _ticks; }
+  int GetLevelsCleared() const { return _levelsCleared; }
+  int GetDeaths() const { return _deaths; }
+  int GetGameOvers() const { return _gameOvers; }
+  int GetBestScore() const { return _bestScore; }
+  int GetScore() const { return _simulation.GetScore(); }
+  int GetEnemiesDeployed() const { return _enemiesDeployed; }
+
+private:
+  // Steps onto an unvisited neighbour when there is one, any neighbour on the grid otherwise, from a random start.
+  GameSimulation::PlayerMove ChooseMove()
+  {
+    int first = (int)_botRandom.NextBelow(4);
+
+    ChunkedStateGrid *tiles = _simulation.GetTiles();
+    int gridX = _simulation.GetPlayerGridX();
+    int gridZ = _simulation.GetPlayerGridZ();
+    int fallback = -1;
+    for (int i = 0; i < 4; i++)
+    {
+      int direction = (first + i) & 3;
+      Uint8 state = tiles->Get(gridX + kMoveSteps[direction][0], gridZ + kMoveSteps[direction][1]);
+      if (state == GameSimulation::TILE_UNVISITED)
+      {
+        return kMoves[direction];
+      }
+      if (state != ChunkedStateGrid::kNotLoaded && fallback == -1)
+      {
+        fallback = direction;
+      }
+    }
+
+    return (fallback != -1) ? kMoves[fallback] : GameSimulation::MOVE_NONE;
+  }
+
+  void UpdateBestScore()
+  {
+    if (_simulation.GetScore() > _bestScore)
+    {
+      _bestScore = _simulation.GetScore();
+    }
+  }
+
+  void OnPlayerDied(const EventRange<PlayerDiedEvent> &events) { _deaths += events.GetCount(); }
+  void OnLevelCleared(const EventRange<LevelClearedEvent> &events) { _levelsCleared += events.GetCount(); }
+  void OnGameReset(const EventRange<GameResetEvent> &events) { _gameOvers += events.GetCount(); }
+
+  GameSimulation _simulation;
+  Random _botRandom;
+  int _ticks;
+  int _levelsCleared;
+  int _deaths;
+  int _gameOvers;
+  int _bestScore;
+  int _enemiesDeployed;
+};
+
+int main(int argc, char** argv)
+{
+  int instanceCount = 64;
+  int ticks = 60 * 60;
+  int threadCount = 0;
+  int levelSize = 4;
+  int enemyCount = 0;
+  int activeRadius = 0;
+  Uint32 seed = 1;
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "--instances") == 0 && i + 1 < argc)
+    {
+      instanceCount = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc)
+    {
+      ticks = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+    {
+      threadCount = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "--level-size") == 0 && i + 1 < argc)
+    {
+      levelSize = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "--enemies") == 0 && i + 1 < argc)
+    {
+      enemyCount = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "--active-radius") == 0 && i + 1 < argc)
+    {
+      activeRadius = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+    {
+      seed = (Uint32)strtoul(argv[++i], nullptr, 10);
+    }
+    else
+    {
+      instanceCount = 0;
+      break;
+    }
+  }
+
+  if (instanceCount <= 0 || ticks <= 0 || threadCount < 0 || levelSize < 2 || enemyCount < 0 || activeRadius < 0)
+  {
+    printf("usage: SimRunner [--instances <count>] [--ticks <count>] [--threads <count>] [--level-size <tiles>] "
+      "[--enemies <count>] [--active-radius <chunks>] [--seed <seed>]\n");
+    return 1;
+  }
+
+  // Built here rather than on the workers: the game's event types get their ids on first use, without locking.
+  std::vector<Instance *> instances;
+  for (int i = 0; i < instanceCount; i++)
+  {
+    instances.push_back(new Instance());
+    instances.back()->Initialize(seed + i, levelSize, enemyCount, activeRadius);
+  }
+
+  // Every instance starts on the same level, but say so if any of them ran out of room.
+  if (enemyCount > 0)
+  {
+    int fewestDeployed = enemyCount;
+    for (auto itr = instances.begin(); itr != instances.end(); itr++)
+    {
+      fewestDeployed = ((*itr)->GetEnemiesDeployed() < fewestDeployed) ? (*itr)->GetEnemiesDeployed() : fewestDeployed;
+    }
+
+    printf("SimRunner: deployed %d of %d enemies per instance%s\n", fewestDeployed, enemyCount,
+      (fewestDeployed < enemyCount) ? ", the rest don't fit around the player, see --active-radius and --level-size" : "");
+  }
+
+  {
+    // One job per instance, the pool hands them to whichever worker is free. The main thread only waits, so by
+    // default every core gets a worker.
+    ThreadPool threadPool((threadCount > 0) ? threadCount : SDL_GetCPUCount());
+    printf("SimRunner: %d instances, %d ticks each, %d threads\n", instanceCount, ticks, threadPool.GetThreadCount());
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    std::vector<std::future<void> > jobs;
+    for (auto itr = instances.begin(); itr != instances.end(); itr++)
+    {
+      Instance *instance = *itr;
+      jobs.push_back(threadPool.Submit([instance, ticks]() { instance->Run(ticks); }));
+    }
+    for (auto itr = jobs.begin(); itr != jobs.end(); itr++)
+    {
+      itr->wait();
+    }
+    double seconds = (double)(SDL_GetPerformanceCounter() - start) / (double)SDL_GetPerformanceFrequency();
+
+    double totalTicks = (double)instanceCount * ticks;
+    printf("SimRunner: %.0f ticks in %.3f s, %.0f ticks per second, %.2f us per tick per worker\n",
+      totalTicks, seconds, totalTicks / seconds, seconds * threadPool.GetThreadCount() * 1000000.0 / totalTicks);
+  }
+
+  int levelsCleared = 0;
+  int deaths = 0;
+  int gameOvers = 0;
+  int bestScore = 0;
+  double scoreSum = 0;
+  for (auto itr = instances.begin(); itr != instances.end(); itr++)
+  {
+    levelsCleared += (*itr)->GetLevelsCleared();
+    deaths += (*itr)->GetDeaths();
+    gameOvers += (*itr)->GetGameOvers();
+    bestScore = ((*itr)->GetBestScore() > bestScore) ? (*itr)->GetBestScore() : bestScore;
+    scoreSum += (*itr)->GetScore();
+    delete *itr;
+  }
+
+  printf("SimRunner: %d levels cleared, %d deaths, %d game overs, best score %d, mean final score %.1f\n",
+    levelsCleared, deaths, gameOvers, bestScore, scoreSum / instanceCount);
+  return 0;
+}